@@ -120,6 +120,7 @@ public:
         ImGui::Text("  Executed Draw Calls: %zu", stats.executedDrawCalls);
         ImGui::Text("  Views Rendered: %zu", stats.viewsRendered);
         ImGui::Text("  Custom Cmds: %zu", stats.customCommands);
+        ImGui::Text("  Debug Lines: %zu", stats.debugLines);
         ImGui::Text("  Sort Time: %.3f ms", stats.sortTimeMs);
         ImGui::Text("  Flush Time: %.3f ms", stats.flushTimeMs);
         ImGui::Separator();
@@ -8,9 +8,11 @@
 #include "transformer.hpp"
 #include "collision/collision_system.hpp"
 #include "collision/shape/box_collider.hpp"
+#include "collision/shape/capsule_collider.hpp"
 #include "collision/shape/circle_collider.hpp"
 #include "collision/shape/obb_collider.hpp"
 #include "collision/shape/polygon_collider.hpp"
+#include "collision/shape/tile_grid_collider.hpp"
 
 using namespace rlge;
 
@@ -107,7 +109,7 @@ public:
             ColliderLayerMask::LAYER_PLAYER,
             localCenter,
             radius,
-            false);
+            false).setStatic(true);
     }
 
     void draw() override {
@@ -141,7 +143,7 @@ public:
             ColliderLayerMask::LAYER_WORLD,
             ColliderLayerMask::LAYER_PLAYER,
             local,
-            false);
+            false).setStatic(true);
     }
 
     void draw() override {
@@ -186,7 +188,7 @@ public:
             ColliderLayerMask::LAYER_WORLD,
             ColliderLayerMask::LAYER_PLAYER,
             std::move(localPoints),
-            false);
+            false).setStatic(true);
     }
 
     void draw() override {
@@ -211,6 +213,96 @@ public:
     }
 };
 
+class StaticCapsuleEntity final : public RenderEntity {
+public:
+    explicit StaticCapsuleEntity(Scene& s)
+        : RenderEntity(s) {
+        auto& tr = add<rlge::Transform>();
+        tr.position = {600.0f, 380.0f};
+        tr.rotation = -0.6f;
+
+        auto& sys = scene().runtime().services().collisions();
+        add<CapsuleCollider>(
+            sys,
+            ColliderType::Solid,
+            ColliderLayerMask::LAYER_WORLD,
+            ColliderLayerMask::LAYER_PLAYER,
+            Vector2{-50.0f, 0.0f},
+            Vector2{50.0f, 0.0f},
+            18.0f,
+            false).setStatic(true);
+    }
+
+    void draw() override {
+        RenderEntity::draw();
+
+        rq().submitWorld([this] {
+            const auto* col = get<CapsuleCollider>();
+            if (!col)
+                return;
+
+            constexpr Color c{120, 180, 255, 255};
+            DrawLineEx(col->start(), col->end(), col->radius() * 2.0f, c);
+            DrawCircleV(col->start(), col->radius(), c);
+            DrawCircleV(col->end(), col->radius(), c);
+        });
+    }
+};
+
+class StaticTileGridEntity final : public RenderEntity {
+public:
+    explicit StaticTileGridEntity(Scene& s)
+        : RenderEntity(s) {
+        auto& tr = add<rlge::Transform>();
+        tr.position = {40.0f, 340.0f};
+
+        // A one-tile floor with a wall standing on it: the floor tile under the wall is only open at the bottom,
+        // so walking into the inside corner must not push the box out through the floor.
+        constexpr int columns = 12;
+        constexpr int rows = 6;
+        std::vector<std::uint8_t> solid(columns * rows, 0);
+        for (int x = 0; x < columns; ++x) {
+            solid[(rows - 1) * columns + x] = 1;
+        }
+        for (int y = 0; y < rows; ++y) {
+            solid[y * columns + 8] = 1;
+        }
+
+        auto& sys = scene().runtime().services().collisions();
+        add<TileGridCollider>(
+            sys,
+            ColliderType::Solid,
+            ColliderLayerMask::LAYER_WORLD,
+            ColliderLayerMask::LAYER_PLAYER,
+            columns,
+            rows,
+            Vector2{16.0f, 16.0f},
+            std::move(solid));
+    }
+
+    void draw() override {
+        RenderEntity::draw();
+
+        rq().submitWorld([this] {
+            const auto* col = get<TileGridCollider>();
+            const auto* tr = get<rlge::Transform>();
+            if (!col || !tr)
+                return;
+
+            const Vector2 size = col->tileSize();
+            constexpr Color c{200, 160, 110, 255};
+            for (int y = 0; y < col->rows(); ++y) {
+                for (int x = 0; x < col->columns(); ++x) {
+                    if (col->solid(x, y))
+                        DrawRectangleRec(Rectangle{tr->position.x + static_cast<float>(x) * size.x,
+                                                   tr->position.y + static_cast<float>(y) * size.y, size.x, size.y},
+                                         c);
+                }
+            }
+        });
+    }
+};
+
 class CollisionDemoScene final : public Scene, public HasDebugOverlay {
 public:
     explicit CollisionDemoScene(Runtime& r) :
@@ -224,6 +316,8 @@ public:
         spawn<StaticCircleEntity>();
         spawn<StaticBoxEntity>();
         spawn<StaticPolygonEntity>();
+        spawn<StaticCapsuleEntity>();
+        spawn<StaticTileGridEntity>();
     }
 
     void update(const float dt) override {
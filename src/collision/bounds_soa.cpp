@@ -0,0 +1,176 @@
+#include "bounds_soa.hpp"
+
+#include <bit>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RLGE_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RLGE_HAS_SSE2 1
+#endif
+
+namespace rlge {
+
+    namespace {
+        bool accepts(const BoundsSoA& s, const std::uint32_t i, const std::uint32_t j) {
+            return (s.layer[j] & s.mask[i]) != 0 && (s.layer[i] & s.mask[j]) != 0;
+        }
+
+        void sweepScalar(const BoundsSoA& s, const std::uint32_t i, std::vector<std::uint32_t>& hits) {
+            const auto n = static_cast<std::uint32_t>(s.size());
+            const float maxX = s.maxX[i];
+            const float minY = s.minY[i];
+            const float maxY = s.maxY[i];
+            // Sorted by minX, so every later entry starts at or after minX[i]; only the upper bound needs testing.
+            for (auto j = i + 1; j < n && s.minX[j] <= maxX; ++j) {
+                if (s.minY[j] <= maxY && minY <= s.maxY[j] && accepts(s, i, j))
+                    hits.push_back(j);
+            }
+        }
+
+        void emitLanes(unsigned bits, const std::uint32_t base, std::vector<std::uint32_t>& hits) {
+            while (bits != 0) {
+                hits.push_back(base + static_cast<std::uint32_t>(std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+
+#if RLGE_HAS_SSE2
+        void sweepSse2(const BoundsSoA& s, const std::uint32_t i, std::vector<std::uint32_t>& hits) {
+            const auto n = static_cast<std::uint32_t>(s.size());
+            const auto maxX = _mm_set1_ps(s.maxX[i]);
+            const auto minY = _mm_set1_ps(s.minY[i]);
+            const auto maxY = _mm_set1_ps(s.maxY[i]);
+            const auto layer = _mm_set1_epi32(static_cast<int>(s.layer[i]));
+            const auto mask = _mm_set1_epi32(static_cast<int>(s.mask[i]));
+            const auto zero = _mm_setzero_si128();
+
+            for (auto j = i + 1; j < n; j += 4) {
+                const auto inX = _mm_cmple_ps(_mm_loadu_ps(&s.minX[j]), maxX);
+                const auto reach = static_cast<unsigned>(_mm_movemask_ps(inX));
+                if (reach == 0)
+                    break;
+
+                auto hit = _mm_and_ps(inX, _mm_cmple_ps(_mm_loadu_ps(&s.minY[j]), maxY));
+                hit = _mm_and_ps(hit, _mm_cmple_ps(minY, _mm_loadu_ps(&s.maxY[j])));
+
+                const auto otherLayer = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s.layer[j]));
+                const auto otherMask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s.mask[j]));
+                const auto rejected = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(otherLayer, mask), zero),
+                                                   _mm_cmpeq_epi32(_mm_and_si128(layer, otherMask), zero));
+                hit = _mm_andnot_ps(_mm_castsi128_ps(rejected), hit);
+
+                // Padding entries never pass the layer test, so lanes past the end need no extra masking.
+                emitLanes(static_cast<unsigned>(_mm_movemask_ps(hit)), j, hits);
+            }
+        }
+#endif
+
+#if RLGE_HAS_AVX2
+        void sweepAvx2(const BoundsSoA& s, const std::uint32_t i, std::vector<std::uint32_t>& hits) {
+            const auto n = static_cast<std::uint32_t>(s.size());
+            const auto maxX = _mm256_set1_ps(s.maxX[i]);
+            const auto minY = _mm256_set1_ps(s.minY[i]);
+            const auto maxY = _mm256_set1_ps(s.maxY[i]);
+            const auto layer = _mm256_set1_epi32(static_cast<int>(s.layer[i]));
+            const auto mask = _mm256_set1_epi32(static_cast<int>(s.mask[i]));
+            const auto zero = _mm256_setzero_si256();
+
+            for (auto j = i + 1; j < n; j += 8) {
+                const auto inX = _mm256_cmp_ps(_mm256_loadu_ps(&s.minX[j]), maxX, _CMP_LE_OQ);
+                const auto reach = static_cast<unsigned>(_mm256_movemask_ps(inX));
+                if (reach == 0)
+                    break;
+
+                auto hit = _mm256_and_ps(inX, _mm256_cmp_ps(_mm256_loadu_ps(&s.minY[j]), maxY, _CMP_LE_OQ));
+                hit = _mm256_and_ps(hit, _mm256_cmp_ps(minY, _mm256_loadu_ps(&s.maxY[j]), _CMP_LE_OQ));
+
+                const auto otherLayer = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s.layer[j]));
+                const auto otherMask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s.mask[j]));
+                const auto rejected = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_and_si256(otherLayer, mask), zero),
+                                                      _mm256_cmpeq_epi32(_mm256_and_si256(layer, otherMask), zero));
+                hit = _mm256_andnot_ps(_mm256_castsi256_ps(rejected), hit);
+
+                emitLanes(static_cast<unsigned>(_mm256_movemask_ps(hit)), j, hits);
+            }
+        }
+#endif
+    }
+
+    SimdLevel compiledSimdLevel() {
+#if RLGE_HAS_AVX2
+        return SimdLevel::Avx2;
+#elif RLGE_HAS_SSE2
+        return SimdLevel::Sse2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    void BoundsSoA::clear() {
+        minX.clear();
+        minY.clear();
+        maxX.clear();
+        maxY.clear();
+        layer.clear();
+        mask.clear();
+        size_ = 0;
+    }
+
+    void BoundsSoA::reserve(const std::size_t n) {
+        minX.reserve(n + padding);
+        minY.reserve(n + padding);
+        maxX.reserve(n + padding);
+        maxY.reserve(n + padding);
+        layer.reserve(n + padding);
+        mask.reserve(n + padding);
+    }
+
+    void BoundsSoA::push(const Aabb& box, const std::uint32_t layerBits, const std::uint32_t maskBits) {
+        minX.push_back(box.minX);
+        minY.push_back(box.minY);
+        maxX.push_back(box.maxX);
+        maxY.push_back(box.maxY);
+        layer.push_back(layerBits);
+        mask.push_back(maskBits);
+        ++size_;
+    }
+
+    void BoundsSoA::finish() {
+        // Inverted boxes with no layer bits: they end every sweep and never match anything.
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        for (std::size_t k = 0; k < padding; ++k) {
+            minX.push_back(inf);
+            minY.push_back(inf);
+            maxX.push_back(-inf);
+            maxY.push_back(-inf);
+            layer.push_back(0);
+            mask.push_back(0);
+        }
+    }
+
+    void sweepOverlaps(const BoundsSoA& sorted, const std::uint32_t i, std::vector<std::uint32_t>& hits,
+                       SimdLevel level) {
+        if (level > compiledSimdLevel())
+            level = compiledSimdLevel();
+        switch (level) {
+#if RLGE_HAS_AVX2
+        case SimdLevel::Avx2:
+            sweepAvx2(sorted, i, hits);
+            return;
+#endif
+#if RLGE_HAS_SSE2
+        case SimdLevel::Sse2:
+            sweepSse2(sorted, i, hits);
+            return;
+#endif
+        default:
+            sweepScalar(sorted, i, hits);
+            return;
+        }
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "broad_phase.hpp"
+
+namespace rlge {
+
+    enum class SimdLevel {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    // Widest instruction set the overlap kernels were compiled for (see the RLGE_AVX2 CMake option).
+    [[nodiscard]] SimdLevel compiledSimdLevel();
+
+    // Structure-of-arrays copy of collider bounds plus layer and mask bits, laid out for the SIMD overlap kernels.
+    // After finish(), every array is followed by a block of empty boxes so kernels can always load full registers.
+    struct BoundsSoA {
+        static constexpr std::size_t padding = 8;
+
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+        std::vector<std::uint32_t> layer;
+        std::vector<std::uint32_t> mask;
+
+        void clear();
+        void reserve(std::size_t n);
+        void push(const Aabb& box, std::uint32_t layerBits, std::uint32_t maskBits);
+        void finish();
+
+        [[nodiscard]] std::size_t size() const { return size_; }
+
+    private:
+        std::size_t size_ = 0;
+    };
+
+    // Expects the entries to be sorted by minX. Appends to hits every j > i whose box overlaps box i (touching
+    // counts) and whose layer and mask bits accept box i both ways. Stops at the first j with minX[j] > maxX[i].
+    void sweepOverlaps(const BoundsSoA& sorted, std::uint32_t i, std::vector<std::uint32_t>& hits,
+                       SimdLevel level = compiledSimdLevel());
+}
@@ -0,0 +1,112 @@
+#include "box_pruning.hpp"
+
+#include <algorithm>
+
+#include "collider.hpp"
+
+namespace rlge {
+
+    BoxPruning::BoxPruning(const BroadPhaseConfig&) {}
+
+    ProxyId BoxPruning::createProxy(Collider* collider, const Rectangle& bounds) {
+        ProxyId id;
+        if (!free_.empty()) {
+            id = free_.back();
+            free_.pop_back();
+        }
+        else {
+            id = static_cast<ProxyId>(proxies_.size());
+            proxies_.emplace_back();
+        }
+
+        auto& p = proxies_[id];
+        p.collider = collider;
+        p.box = Aabb::fromRect(bounds);
+        p.layer = static_cast<std::uint32_t>(collider->layer());
+        p.mask = static_cast<std::uint32_t>(collider->mask());
+        p.alive = true;
+        order_.push_back(id);
+        ++added_;
+        return id;
+    }
+
+    void BoxPruning::destroyProxy(const ProxyId proxy) {
+        // The id stays out of the free list until order_ has been compacted, so it is never listed twice.
+        proxies_[proxy] = Proxy{};
+        removed_ = true;
+    }
+
+    void BoxPruning::moveProxy(const ProxyId proxy, const Rectangle& bounds) {
+        proxies_[proxy].box = Aabb::fromRect(bounds);
+    }
+
+    void BoxPruning::sort_() {
+        if (removed_) {
+            std::erase_if(order_, [this](const ProxyId id) {
+                if (proxies_[id].alive)
+                    return false;
+                free_.push_back(id);
+                return true;
+            });
+            removed_ = false;
+        }
+
+        const auto minX = [this](const ProxyId id) { return proxies_[id].box.minX; };
+        if (added_ * 4 >= order_.size()) {
+            // Too many newcomers for insertion sort to stay cheap.
+            std::ranges::sort(order_, {}, minX);
+        }
+        else {
+            for (std::size_t i = 1; i < order_.size(); ++i) {
+                const auto id = order_[i];
+                const auto key = minX(id);
+                auto j = i;
+                for (; j > 0 && minX(order_[j - 1]) > key; --j) {
+                    order_[j] = order_[j - 1];
+                }
+                order_[j] = id;
+            }
+        }
+        added_ = 0;
+    }
+
+    void BoxPruning::refresh() {
+        sort_();
+
+        sorted_.clear();
+        sorted_.reserve(order_.size());
+        maxWidth_ = 0.0f;
+        for (const auto id : order_) {
+            const auto& p = proxies_[id];
+            sorted_.push(p.box, p.layer, p.mask);
+            maxWidth_ = std::max(maxWidth_, p.box.maxX - p.box.minX);
+        }
+        sorted_.finish();
+    }
+
+    void BoxPruning::collectPairs(std::vector<ColliderPair>& out) {
+        refresh();
+        for (std::uint32_t i = 0; i < order_.size(); ++i) {
+            hits_.clear();
+            sweepOverlaps(sorted_, i, hits_);
+            auto* a = proxies_[order_[i]].collider;
+            for (const auto j : hits_) {
+                out.push_back(ColliderPair{a, proxies_[order_[j]].collider});
+            }
+        }
+    }
+
+    void BoxPruning::query(const Aabb& box, std::vector<Collider*>& out) const {
+        // Binary search on the sorted minX column: a box overlapping the query starts at most maxWidth_ before it.
+        const auto first = sorted_.minX.begin();
+        const auto last = first + static_cast<std::ptrdiff_t>(sorted_.size());
+        const auto begin = std::lower_bound(first, last, box.minX - maxWidth_);
+        const auto end = std::upper_bound(begin, last, box.maxX);
+        for (auto it = begin; it != end; ++it) {
+            const auto& p = proxies_[order_[static_cast<std::size_t>(it - first)]];
+            if (p.alive && p.box.overlaps(box))
+                out.push_back(p.collider);
+        }
+    }
+
+}
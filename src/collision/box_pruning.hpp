@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "bounds_soa.hpp"
+#include "broad_phase.hpp"
+#include "raylib.h"
+
+namespace rlge {
+
+    // Single-axis sort and sweep over a structure-of-arrays copy of every proxy's bounds and layer bits. Each
+    // frame the proxies are re-sorted by minX (insertion sort, so coherent motion stays near linear) and every
+    // proxy is tested against the run of proxies that start before it ends, 4 or 8 at a time with SSE2/AVX2.
+    // Layer and mask bits are checked in the same pass, so filtered pairs never reach the narrow phase.
+    class BoxPruning final : public BroadPhase {
+    public:
+        explicit BoxPruning(const BroadPhaseConfig& config = {});
+
+        ProxyId createProxy(Collider* collider, const Rectangle& bounds) override;
+        void destroyProxy(ProxyId proxy) override;
+        void moveProxy(ProxyId proxy, const Rectangle& bounds) override;
+        void collectPairs(std::vector<ColliderPair>& out) override;
+        void refresh() override;
+        void query(const Aabb& box, std::vector<Collider*>& out) const override;
+
+    private:
+        struct Proxy {
+            Collider* collider = nullptr;
+            Aabb box;
+            std::uint32_t layer = 0;
+            std::uint32_t mask = 0;
+            bool alive = false;
+        };
+
+        void sort_();
+
+        std::vector<Proxy> proxies_;
+        std::vector<ProxyId> free_;
+        std::vector<ProxyId> order_; // proxy ids by minX, persisted between frames
+        std::size_t added_ = 0;
+        float maxWidth_ = 0.0f; // widest proxy on x at the last refresh, bounds the query scan
+        bool removed_ = false;
+        BoundsSoA sorted_;
+        std::vector<std::uint32_t> hits_;
+    };
+
+}
@@ -0,0 +1,24 @@
+#include "broad_phase.hpp"
+
+#include "box_pruning.hpp"
+#include "dynamic_aabb_tree.hpp"
+#include "spatial_hash.hpp"
+#include "sweep_and_prune.hpp"
+
+namespace rlge {
+
+    std::unique_ptr<BroadPhase> makeBroadPhase(const BroadPhaseType type, const BroadPhaseConfig& config) {
+        switch (type) {
+        case BroadPhaseType::DynamicTree:
+            return std::make_unique<DynamicAabbTree>(config);
+        case BroadPhaseType::SweepAndPrune:
+            return std::make_unique<SweepAndPrune>(config);
+        case BroadPhaseType::BoxPruning:
+            return std::make_unique<BoxPruning>(config);
+        case BroadPhaseType::SpatialHash:
+        default:
+            return std::make_unique<SpatialHash>(config);
+        }
+    }
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "collider_types.hpp"
+#include "raylib.h"
+
+namespace rlge {
+    class Collider;
+
+    // Axis-aligned box stored as min/max corners, which is cheaper than Rectangle for merging and containment tests.
+    struct Aabb {
+        float minX = 0.0f;
+        float minY = 0.0f;
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+
+        [[nodiscard]] static Aabb fromRect(const Rectangle& r) { return {r.x, r.y, r.x + r.width, r.y + r.height}; }
+
+        [[nodiscard]] static Aabb merge(const Aabb& a, const Aabb& b) {
+            return {
+                a.minX < b.minX ? a.minX : b.minX,
+                a.minY < b.minY ? a.minY : b.minY,
+                a.maxX > b.maxX ? a.maxX : b.maxX,
+                a.maxY > b.maxY ? a.maxY : b.maxY
+            };
+        }
+
+        // Touching boxes count as overlapping, so the broad phase never drops a pair CheckCollisionRecs would keep.
+        [[nodiscard]] bool overlaps(const Aabb& o) const {
+            return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+        }
+
+        [[nodiscard]] bool contains(const Aabb& o) const {
+            return minX <= o.minX && minY <= o.minY && o.maxX <= maxX && o.maxY <= maxY;
+        }
+
+        [[nodiscard]] float perimeter() const { return 2.0f * ((maxX - minX) + (maxY - minY)); }
+    };
+
+    using ProxyId = std::int32_t;
+    inline constexpr ProxyId NullProxy = -1;
+
+    enum class BroadPhaseType {
+        SpatialHash,
+        DynamicTree,
+        SweepAndPrune,
+        BoxPruning,
+    };
+
+    struct BroadPhaseConfig {
+        // Edge length of the spatial hash cells, in world units.
+        float cellSize = 64.0f;
+        // Extra room around each dynamic tree proxy, so small movements do not require a reinsert.
+        float treeMargin = 8.0f;
+        // How far a tree proxy is extended along its last displacement, as a multiple of that displacement.
+        float treeDisplacementMultiplier = 2.0f;
+    };
+
+    // Interface for the structures that produce candidate pairs for the narrow phase.
+    // Every collider owns exactly one proxy, created on its first update and moved every frame after that.
+    class BroadPhase {
+    public:
+        virtual ~BroadPhase() = default;
+
+        virtual ProxyId createProxy(Collider* collider, const Rectangle& bounds) = 0;
+        virtual void destroyProxy(ProxyId proxy) = 0;
+        virtual void moveProxy(ProxyId proxy, const Rectangle& bounds) = 0;
+
+        // Appends every pair whose proxies may overlap. Each pair is reported once, in no particular order.
+        // Also refreshes the structure like refresh() does.
+        virtual void collectPairs(std::vector<ColliderPair>& out) = 0;
+
+        // Brings the structure up to date for query() without collecting pairs, for proxies that are only
+        // paired with colliders of other structures.
+        virtual void refresh() {}
+
+        // Appends every collider whose proxy overlaps the box, each once. Answers from the state of the last
+        // collectPairs or refresh, so proxies created or moved after it are not seen yet.
+        virtual void query(const Aabb& box, std::vector<Collider*>& out) const = 0;
+
+        virtual void configure(const BroadPhaseConfig&) {}
+    };
+
+    std::unique_ptr<BroadPhase> makeBroadPhase(BroadPhaseType type, const BroadPhaseConfig& config);
+}
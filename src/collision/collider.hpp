@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
+
+#include "broad_phase.hpp"
 #include "collider_types.hpp"
 #include "collision_system.hpp"
 #include "entity.hpp"
+#include "narrow_phase.hpp"
 #include "raylib.h"
+#include "raymath.h"
 #include "scene.hpp"
 #include "../component.hpp"
 #include "../transformer.hpp"
@@ -41,7 +46,11 @@ namespace rlge {
     class ObbCollider;
     class PolygonCollider;
     class CapsuleCollider;
+    class TileGridCollider;
+    class CircleBatchCollider;
+    class CompoundCollider;
     class CollisionSystem;
+    class RigidBody;
 
     class Collider : public Component {
     public:
@@ -71,45 +80,86 @@ namespace rlge {
             const auto shapeColor = applyTriggerStyle(colorForLayer(layer_), trigger_);
             constexpr Color aabbColor = {80, 80, 80, 255};
 
-            const auto worldRect = axisAlignedWorldBounds();
-
-            // Draw shape
-            const auto worldPoints = points();
-            entity().scene().rq().submitWorld([worldRect, worldPoints, shapeColor, aabbColor] {
-                DrawRectangleLinesEx(worldRect, 1.0f, aabbColor);
-                const auto n = worldPoints.size();
-                if (n >= 2) {
-                    for (size_t i = 0; i < n; ++i) {
-                        const auto& p1 = worldPoints[i];
-                        const auto& p2 = worldPoints[(i + 1) % n];
-                        DrawLineEx(p1, p2, 2.0f, shapeColor);
-                    }
-                }
-            });
+            // Bounds and outline go into the shared debug line batch, no command per collider
+            auto& rq = entity().scene().rq();
+            rq.submitDebugRect(axisAlignedWorldBounds(), 1.0f, aabbColor);
+            rq.submitDebugLines(points(), true, 2.0f, shapeColor);
         }
 
-        [[nodiscard]] virtual Rectangle axisAlignedWorldBounds() const = 0; // for broad phase collision testing
+        // for broad phase collision testing
+        [[nodiscard]] Rectangle axisAlignedWorldBounds() const { return geometry().bounds; }
 
         [[nodiscard]] virtual CollisionManifold testAgainst(const Collider& other) const = 0;
 
+        // The manifold normal of collideWith points from the argument to this collider, so a.testAgainst(b)
+        // reports a normal from a to b.
         [[nodiscard]] virtual CollisionManifold collideWith(const BoxCollider& b) const = 0;
         [[nodiscard]] virtual CollisionManifold collideWith(const CircleCollider& c) const = 0;
         [[nodiscard]] virtual CollisionManifold collideWith(const ObbCollider& o) const = 0;
         [[nodiscard]] virtual CollisionManifold collideWith(const PolygonCollider& p) const = 0;
+        // Capsules, and any later support-mapped shape, go through the generic GJK/EPA path, so existing
+        // shapes need no dedicated overload. The manifold normal points from the capsule to this collider.
+        [[nodiscard]] virtual CollisionManifold collideWith(const CapsuleCollider& c) const;
+        // Tests this collider against the solid tiles its bounds cover. Normal points from the grid to this.
+        [[nodiscard]] virtual CollisionManifold collideWith(const TileGridCollider& g) const;
+        // Whether any circle of the batch touches this collider; the manifold carries no normal or depth.
+        [[nodiscard]] virtual CollisionManifold collideWith(const CircleBatchCollider& b) const;
+        // Deepest contact with the children of the compound. Normal points from the compound to this.
+        [[nodiscard]] virtual CollisionManifold collideWith(const CompoundCollider& c) const;
+
+        // Overlap-only counterparts of testAgainst/collideWith, for pairs that need no manifold. They agree with
+        // the manifold's `colliding` but stop at the first separating axis.
+        [[nodiscard]] virtual bool testOverlap(const Collider& other) const = 0;
+
+        [[nodiscard]] virtual bool overlapWith(const BoxCollider& b) const = 0;
+        [[nodiscard]] virtual bool overlapWith(const CircleCollider& c) const = 0;
+        [[nodiscard]] virtual bool overlapWith(const ObbCollider& o) const = 0;
+        [[nodiscard]] virtual bool overlapWith(const PolygonCollider& p) const = 0;
+        [[nodiscard]] virtual bool overlapWith(const CapsuleCollider& c) const;
+        [[nodiscard]] virtual bool overlapWith(const TileGridCollider& g) const;
+        [[nodiscard]] virtual bool overlapWith(const CircleBatchCollider& b) const;
+        [[nodiscard]] virtual bool overlapWith(const CompoundCollider& c) const;
+
+        // World-space support mapping used by the GJK/EPA narrow phase.
+        [[nodiscard]] virtual ConvexSupport convexSupport() const = 0;
+
+        // Exact tests behind the spatial queries; colliders made of more than one convex piece override them.
+        [[nodiscard]] virtual bool overlaps(const ConvexSupport& shape) const {
+            return narrow_phase::convexOverlap(shape, convexSupport());
+        }
 
-        [[nodiscard]] virtual std::vector<Vector2> points() const = 0;
+        [[nodiscard]] virtual bool castAgainst(const ConvexSupport& shape, const Vector2 motion, CastHit& hit) const {
+            return narrow_phase::cast(shape, convexSupport(), motion, hit);
+        }
+
+        [[nodiscard]] const std::vector<Vector2>& points() const { return geometry().points; }
+        [[nodiscard]] const std::vector<Vector2>& normals() const { return geometry().normals; }
 
+        [[nodiscard]] const ColliderGeometry& geometry() const {
+            if (!transform_)
+                transform_ = entity().get<Transform>();
+            const auto version = transform_ ? transform_->version() : 0u;
+            if (!geometryValid_ || version != geometryVersion_ || transform_ != geometryTransform_) {
+                rebuildGeometry(geometry_, transform_);
+                geometryVersion_ = version;
+                geometryTransform_ = transform_;
+                geometryValid_ = true;
+                ++revision_;
+            }
+            return geometry_;
+        }
+
+        [[nodiscard]] virtual ColliderShape shape() const = 0;
         [[nodiscard]] ColliderType type() const { return type_; }
         [[nodiscard]] ColliderLayerMask layer() const { return layer_; }
         [[nodiscard]] ColliderLayerMask mask() const { return mask_; }
 
-        virtual void resolve(const CollisionManifold& m) {
-            if (!m.colliding || trigger_)
-                return;
-            const auto t = entity().get<Transform>();
-            t->position.x -= m.normal.x * m.depth * 0.5f;
-            t->position.y -= m.normal.y * m.depth * 0.5f;
-        };
+        // Applies the position correction the solver settled on for this update. Only solid, non-static,
+        // non-trigger colliders are ever corrected.
+        virtual void resolve(const Vector2 correction) {
+            if (auto* t = entity().get<Transform>())
+                t->position = Vector2Add(t->position, correction);
+        }
 
         void setOnCollision(CollisionCallback cb) {
             onCollision_ = std::move(cb);
@@ -123,14 +173,161 @@ namespace rlge {
             }
         }
 
+        // Contact lifecycle callbacks. Enter fires on the first frame two colliders touch, stay on every
+        // following frame they still touch, and exit once they separate. When a collider is destroyed while
+        // touching, its partners receive exit with a pointer that must only be used for identity checks.
+        void setOnCollisionEnter(CollisionCallback cb) { onCollisionEnter_ = std::move(cb); }
+        void setOnCollisionStay(CollisionCallback cb) { onCollisionStay_ = std::move(cb); }
+        void setOnCollisionExit(CollisionCallback cb) { onCollisionExit_ = std::move(cb); }
+
+        void onCollisionEnter(const Collider* other) const {
+            if (onCollisionEnter_) {
+                onCollisionEnter_(other);
+            }
+        }
+
+        void onCollisionStay(const Collider* other) const {
+            if (onCollisionStay_) {
+                onCollisionStay_(other);
+            }
+        }
+
+        void onCollisionExit(const Collider* other) const {
+            if (onCollisionExit_) {
+                onCollisionExit_(other);
+            }
+        }
+
         [[nodiscard]] bool isTrigger() const { return trigger_; };
 
+        // Static colliders (level geometry) live in a separate partition that is built once and never tested
+        // against itself. They are never moved by collision resolution; after moving one by hand, call
+        // CollisionSystem::invalidateStatic().
+        void setStatic(const bool isStatic) {
+            if (isStatic == static_)
+                return;
+            static_ = isStatic;
+            system_.staticChanged_(this);
+        }
+
+        [[nodiscard]] bool isStatic() const { return static_; }
+
+        // Continuous colliders are swept from where the previous update left them to where they are now, so fast
+        // movers cannot tunnel through thin colliders. Only the translation is swept, and the shapes are
+        // approximated by their bounds (circles stay circles). The contact's manifold reports the time of impact.
+        void setContinuous(const bool continuous) {
+            continuous_ = continuous;
+            resetSweep();
+        }
+
+        [[nodiscard]] bool isContinuous() const { return continuous_; }
+
+        // Forgets the previous position, e.g. after a teleport that should not be swept.
+        void resetSweep() {
+            sweepValid_ = false;
+            sweep_ = Vector2{0.0f, 0.0f};
+        }
+
+    protected:
+        [[nodiscard]] bool debugEnabled() const { return system_.debug(); }
+
+        // For shape changes the Transform does not see: rebuilds the geometry and wakes every pair of this collider.
+        void invalidateGeometry() const { geometryValid_ = false; }
+
+        // Fills the world-space geometry for the given transform (which may be null).
+        // Only called when the transform changed since the last rebuild.
+        virtual void rebuildGeometry(ColliderGeometry& g, const Transform* t) const = 0;
+
+        [[nodiscard]] const Transform* transform() const {
+            if (!transform_)
+                transform_ = entity().get<Transform>();
+            return transform_;
+        }
+
+        // Derives the bounds, edge normals and inline convex copy of a polygonal shape from its world points.
+        static void finishPolygon(ColliderGeometry& g) {
+            const auto& pts = g.points;
+            const size_t n = pts.size();
+            g.normals.resize(n);
+            g.convex.count = 0;
+            if (n == 0) {
+                g.bounds = Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
+                return;
+            }
+
+            float minX = pts[0].x;
+            float minY = pts[0].y;
+            float maxX = pts[0].x;
+            float maxY = pts[0].y;
+
+            for (size_t i = 0; i < n; ++i) {
+                const auto& p = pts[i];
+                if (p.x < minX) minX = p.x;
+                if (p.x > maxX) maxX = p.x;
+                if (p.y < minY) minY = p.y;
+                if (p.y > maxY) maxY = p.y;
+
+                const Vector2 edge = Vector2Subtract(pts[(i + 1) % n], p);
+                const float len = Vector2Length(edge);
+                g.normals[i] = len == 0.0f ? Vector2{0.0f, 0.0f} : Vector2Scale(Vector2{-edge.y, edge.x}, 1.0f / len);
+            }
+
+            g.bounds = Rectangle{minX, minY, maxX - minX, maxY - minY};
+
+            if (n > ConvexShape::capacity)
+                return;
+            Vector2 sum{0.0f, 0.0f};
+            for (size_t i = 0; i < n; ++i) {
+                g.convex.points[i] = pts[i];
+                g.convex.normals[i] = g.normals[i];
+                sum = Vector2Add(sum, pts[i]);
+            }
+            g.convex.count = n;
+            g.convex.center = Vector2Scale(sum, 1.0f / static_cast<float>(n));
+        }
+
     private:
+        friend class CollisionSystem;
+
+        [[nodiscard]] bool sweeping_() const { return sweep_.x != 0.0f || sweep_.y != 0.0f; }
+
+        // Translation since the previous update, including any move a callback already made during this one.
+        [[nodiscard]] Vector2 travelled_() const {
+            const auto* t = transform();
+            if (!continuous_ || static_ || !sweepValid_ || !t)
+                return Vector2{0.0f, 0.0f};
+            return Vector2Subtract(t->position, sweepStart_);
+        }
+
         CollisionSystem& system_;
         ColliderType type_;
         ColliderLayerMask layer_;
         ColliderLayerMask mask_;
         bool trigger_;
         CollisionCallback onCollision_;
+        CollisionCallback onCollisionEnter_;
+        CollisionCallback onCollisionStay_;
+        CollisionCallback onCollisionExit_;
+        bool static_ = false;
+        ProxyId proxy_ = NullProxy;
+        std::uint32_t bucket_ = 0; // layer bucket holding proxy_
+        std::uint32_t bucketSlot_ = 0; // position in that bucket's collider list
+        std::uint64_t order_ = 0; // registration sequence, keeps pair processing deterministic
+        std::uint32_t slot_ = 0; // position in the system's collider list
+        std::uint32_t staticSlot_ = 0; // position in the static list, while static
+        std::uint32_t contacts_ = 0; // active entries in the system's contact cache
+        std::uint32_t solverBody_ = ~0u; // index into the solver's bodies while an update runs
+        RigidBody* body_ = nullptr; // moves this collider's entity, if any
+        bool continuous_ = false;
+        bool sweepValid_ = false;
+        Vector2 sweepStart_{0.0f, 0.0f}; // position at the end of the previous update
+        Vector2 sweep_{0.0f, 0.0f}; // travelled_() at the broad phase refresh
+
+        mutable const Transform* transform_ = nullptr;
+        mutable ColliderGeometry geometry_;
+        mutable const Transform* geometryTransform_ = nullptr;
+        mutable std::uint32_t geometryVersion_ = 0;
+        mutable bool geometryValid_ = false;
+        mutable std::uint32_t revision_ = 0; // bumps on every geometry rebuild; pairs sleep while it holds
     };
 }
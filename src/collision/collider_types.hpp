@@ -1,6 +1,10 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <span>
+#include <vector>
 
 #include "raylib.h"
 
@@ -14,6 +18,19 @@ namespace rlge {
         Kinematic
     };
 
+    enum class ColliderShape : std::uint8_t {
+        Box,
+        Circle,
+        Obb,
+        Polygon,
+        Capsule,
+        TileGrid,
+        CircleBatch,
+        Compound
+    };
+
+    inline constexpr std::size_t colliderShapeCount = static_cast<std::size_t>(ColliderShape::Compound) + 1;
+
     enum class ColliderLayerMask : std::uint32_t {
         LAYER_WORLD  = 1u << 0,
         LAYER_PLAYER = 1u << 1,
@@ -26,11 +43,151 @@ namespace rlge {
         return static_cast<std::uint32_t>(a) & static_cast<std::uint32_t>(b);
     }
 
+    [[nodiscard]] inline ColliderLayerMask operator|(ColliderLayerMask a, ColliderLayerMask b) {
+        return static_cast<ColliderLayerMask>(static_cast<std::uint32_t>(a) | static_cast<std::uint32_t>(b));
+    }
+
+    inline constexpr unsigned colliderLayerCount = 32;
+
+    // Every bit of ColliderLayerMask is a layer; the named ones above are only the engine's defaults.
+    [[nodiscard]] constexpr ColliderLayerMask colliderLayer(const unsigned index) {
+        return static_cast<ColliderLayerMask>(1u << index);
+    }
+
     struct CollisionManifold {
         bool colliding = false;
         Vector2 normal{0.0f, 0.0f};
         float depth = 0.0f;
+        // Fraction of the frame's motion after which the shapes first touched. Only continuous colliders
+        // sweep their motion; discrete contacts report 1 (found at the end of the frame).
+        float toi = 1.0f;
+    };
+
+    // Position correction of overlapping solid colliders. All contacts of an update are gathered first and then
+    // relaxed together, so a collider pushed by several others ends up where all of them agree.
+    struct SolverConfig {
+        // Passes over the contacts. More passes settle stacks and crowds faster.
+        int iterations = 4;
+        // Penetration left in place, in world units. Resting contacts keep touching instead of flickering.
+        float slop = 0.05f;
+        // Fraction of the remaining penetration removed per pass.
+        float baumgarte = 0.8f;
+    };
+
+    // Impulse solver of the rigid bodies. Bodies move in fixed substeps, however long the update was; the
+    // contacts found at the start of an update are reused by all of its substeps.
+    struct PhysicsConfig {
+        // World units per second squared; y points down, like the screen.
+        Vector2 gravity{0.0f, 980.0f};
+        float substep = 1.0f / 240.0f;
+        // Substeps per update at most; time beyond that is dropped, so one long frame cannot snowball.
+        int maxSubsteps = 16;
+        // Passes over the contacts per substep, followed by one pass without position correction.
+        int iterations = 2;
+        // Penetration left in place, in world units. Resting contacts keep touching instead of flickering.
+        float slop = 0.25f;
+        // Fraction of the remaining penetration removed per second, times the substep rate.
+        float baumgarte = 0.2f;
+        // Cap on the speed at which overlapping bodies are pushed apart.
+        float maxPushSpeed = 300.0f;
+        // Contacts approaching slower than this do not bounce, so resting bodies stay put.
+        float restitutionThreshold = 30.0f;
+        // Bodies slower than this for timeToSleep seconds fall asleep, together with everything they touch.
+        float sleepSpeed = 8.0f;
+        float timeToSleep = 0.5f;
+    };
+
+    // Counters and timings of the last CollisionSystem::update
+    struct CollisionStats {
+        std::size_t colliders = 0;
+        std::size_t pairs = 0; // candidates from the broad phase and the static partition
+        std::size_t maskRejected = 0;
+        std::size_t boundsRejected = 0; // candidates whose exact bounds turned out not to overlap
+        std::size_t narrowTests = 0;
+        std::size_t narrowReused = 0; // results of unchanged pairs taken from the previous update
+        std::size_t overlapTests = 0; // narrow tests of trigger pairs the solver ignores, without a manifold
+        std::size_t contacts = 0;
+        std::size_t resolved = 0; // contacts handed to the solver
+        std::size_t bodies = 0; // awake rigid bodies
+        std::size_t bodyContacts = 0; // contacts solved with impulses
+        std::size_t substeps = 0;
+        // Narrow-phase tests per shape pair, indexed by the two ColliderShape values, smaller one first.
+        std::array<std::array<std::size_t, colliderShapeCount>, colliderShapeCount> testsByShape{};
+        float broadPhaseUs = 0.0f;
+        float narrowPhaseUs = 0.0f; // includes the collision callbacks
+        float solverUs = 0.0f;
+        float contactEventsUs = 0.0f; // exit callbacks and the contacts event
+        float totalUs = 0.0f;
+
+        void reset() { *this = CollisionStats{}; }
+    };
+
+    // Convex polygon with inline vertex storage, so SAT tests read one contiguous block and never allocate.
+    struct ConvexShape {
+        static constexpr std::size_t capacity = 8;
+
+        std::array<Vector2, capacity> points{};
+        std::array<Vector2, capacity> normals{};
+        std::size_t count = 0;
+        Vector2 center{0.0f, 0.0f}; // vertex average, orients the contact normal
+
+        [[nodiscard]] std::span<const Vector2> vertices() const { return {points.data(), count}; }
+        [[nodiscard]] std::span<const Vector2> edgeNormals() const { return {normals.data(), count}; }
+    };
+
+    // Support mapping for the GJK/EPA narrow phase: a convex core (vertices, a segment or a single point)
+    // inflated by a radius. The core's furthest vertex in a direction plus radius is the shape's support point.
+    struct ConvexSupport {
+        std::span<const Vector2> core;
+        float radius = 0.0f;
+        Vector2 center{0.0f, 0.0f}; // any interior point; orients the normal when the cores only touch
+    };
+
+    // World-space shape data cached by each collider, rebuilt only when its Transform changes.
+    struct ColliderGeometry {
+        std::vector<Vector2> points;  // world-space vertices; empty for circles and capsules
+        std::vector<Vector2> normals; // unit normal of the edge points[i] -> points[i + 1]; zero for degenerate edges
+        Rectangle bounds{0.0f, 0.0f, 0.0f, 0.0f};
+        // Inline copy of polygonal shapes with at most ConvexShape::capacity vertices; empty for circles and
+        // larger polygons, which the narrow phase reads from the vectors above instead.
+        ConvexShape convex;
+    };
+
+    // Candidate pair produced by the broad phase.
+    struct ColliderPair {
+        Collider* first = nullptr;
+        Collider* second = nullptr;
     };
 
     using CollisionCallback = std::function<void(const Collider*)>;
+
+    // Which colliders a spatial query may return.
+    struct QueryFilter {
+        ColliderLayerMask mask = static_cast<ColliderLayerMask>(~0u); // layers to include
+        bool triggers = true;                                          // include trigger colliders
+        const Collider* ignore = nullptr;                              // e.g. the collider doing the query
+    };
+
+    // First contact of a ray or shape cast.
+    struct CastHit {
+        Collider* collider = nullptr;
+        Vector2 point{0.0f, 0.0f};  // contact point on the hit collider
+        Vector2 normal{0.0f, 0.0f}; // surface normal of the hit collider at point, facing the caster
+        float fraction = 0.0f;      // part of the motion travelled before contact, in [0, 1]
+    };
+
+    struct ContactEvent {
+        Collider* a = nullptr;
+        Collider* b = nullptr; // null in an exit event when this collider was destroyed
+        // Trigger contacts that move neither collider only test for overlap; their normal and depth stay zero.
+        CollisionManifold manifold;
+    };
+
+    // Published through the EventBus once per CollisionSystem::update when any contact began, persisted or ended.
+    // The spans are only valid while the event is being delivered; copy what you need to keep.
+    struct CollisionContactsEvent {
+        std::span<const ContactEvent> entered;
+        std::span<const ContactEvent> stayed;
+        std::span<const ContactEvent> exited;
+    };
 }
@@ -1,59 +1,707 @@
 #include "collision_system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <thread>
+
 #include "collider.hpp"
+#include "events.hpp"
 #include "imgui.h"
+#include "narrow_phase.hpp"
 #include "raylib.h"
 #include "raymath.h"
+#include "rigid_body.hpp"
+#include "shape/box_collider.hpp"
+#include "shape/circle_batch_collider.hpp"
+#include "shape/circle_collider.hpp"
+#include "worker_pool.hpp"
+
+namespace {
+    unsigned defaultWorkerThreads() {
+        const auto hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? std::min(hardware - 1, 7u) : 0u;
+    }
+
+    // Pairs worth handing to the worker pool: a polygon or OBB (SAT), a capsule, tile grid or compound (GJK and
+    // per-piece tests) or a circle batch (many circles) on either side. Box and circle pairs are cheaper to test
+    // inline than to schedule.
+    bool isHeavyPair(const rlge::Collider& a, const rlge::Collider& b) {
+        const auto heavy = [](const rlge::ColliderShape s) {
+            return s == rlge::ColliderShape::Obb || s == rlge::ColliderShape::Polygon ||
+                   s == rlge::ColliderShape::Capsule || s == rlge::ColliderShape::TileGrid ||
+                   s == rlge::ColliderShape::CircleBatch || s == rlge::ColliderShape::Compound;
+        };
+        return heavy(a.shape()) || heavy(b.shape());
+    }
+
+    // Boxes and circles make up most pairs of a crowded scene. Their tests are called directly, by shape pair,
+    // instead of through testAgainst and collideWith; the calls are the ones that double dispatch ends in, so
+    // the manifolds are the same.
+    std::optional<rlge::CollisionManifold> testDirect(const rlge::Collider& a, const rlge::ColliderShape shapeA,
+                                                      const rlge::Collider& b, const rlge::ColliderShape shapeB) {
+        using rlge::ColliderShape;
+        namespace np = rlge::narrow_phase;
+        const auto box = [](const rlge::Collider& c) -> auto& { return static_cast<const rlge::BoxCollider&>(c); };
+        const auto circle = [](const rlge::Collider& c) -> auto& {
+            return static_cast<const rlge::CircleCollider&>(c);
+        };
+
+        if (shapeA == ColliderShape::Box && shapeB == ColliderShape::Box)
+            return np::boxBox(box(b), box(a));
+        if (shapeA == ColliderShape::Box && shapeB == ColliderShape::Circle)
+            return np::boxCircle(box(a), circle(b));
+        if (shapeA == ColliderShape::Circle && shapeB == ColliderShape::Box)
+            return np::flipped(np::boxCircle(box(b), circle(a)));
+        if (shapeA == ColliderShape::Circle && shapeB == ColliderShape::Circle)
+            return np::flipped(np::circleCircle(circle(b), circle(a)));
+        return std::nullopt;
+    }
+
+    // testOverlap counterpart of testDirect.
+    std::optional<bool> overlapDirect(const rlge::Collider& a, const rlge::ColliderShape shapeA,
+                                      const rlge::Collider& b, const rlge::ColliderShape shapeB) {
+        using rlge::ColliderShape;
+        namespace np = rlge::narrow_phase;
+        const auto box = [](const rlge::Collider& c) -> auto& { return static_cast<const rlge::BoxCollider&>(c); };
+        const auto circle = [](const rlge::Collider& c) -> auto& {
+            return static_cast<const rlge::CircleCollider&>(c);
+        };
+
+        if (shapeA == ColliderShape::Box && shapeB == ColliderShape::Box)
+            return np::boxBoxOverlap(box(b), box(a));
+        if (shapeA == ColliderShape::Box && shapeB == ColliderShape::Circle)
+            return np::boxCircleOverlap(box(a), circle(b));
+        if (shapeA == ColliderShape::Circle && shapeB == ColliderShape::Box)
+            return np::boxCircleOverlap(box(b), circle(a));
+        if (shapeA == ColliderShape::Circle && shapeB == ColliderShape::Circle)
+            return np::circleCircleOverlap(circle(b), circle(a));
+        return std::nullopt;
+    }
+
+    // Removes list[slot] by moving the last entry into its place; `slotOf` is the member where entries keep their
+    // own position.
+    template <typename T>
+    void swapRemove(std::vector<T*>& list, const std::uint32_t slot, std::uint32_t T::* const slotOf) {
+        auto* last = list.back();
+        list[slot] = last;
+        if (last)
+            last->*slotOf = slot;
+        list.pop_back();
+    }
+
+    // Union-find root with path halving.
+    std::uint32_t islandRoot(std::vector<std::uint32_t>& parents, std::uint32_t i) {
+        while (parents[i] != i) {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    float microseconds(const Clock::time_point from, const Clock::time_point to) {
+        return std::chrono::duration<float, std::micro>(to - from).count();
+    }
+}
 
 namespace rlge {
 
+    CollisionSystem::CollisionSystem() :
+        workerThreads_(defaultWorkerThreads()) {
+        layerMatrix_.fill(~0u);
+    }
+
+    CollisionSystem::~CollisionSystem() = default;
+
     void CollisionSystem::registerCollider(Collider* c) {
+        // The broad-phase proxy is created on the first update, once the derived collider is fully constructed.
+        c->order_ = nextOrder_++;
+        c->slot_ = static_cast<std::uint32_t>(colliders_.size());
         colliders_.push_back(c);
     }
 
     void CollisionSystem::unregisterCollider(Collider* c) {
+        if (c->proxy_ != NullProxy)
+            removeProxy_(c);
+        if (c->static_) {
+            swapRemove(staticColliders_, c->staticSlot_, &Collider::staticSlot_);
+            staticDirty_ = true;
+        }
+        if (c->contacts_ > 0)
+            dropContacts_(c);
+        if (c->solverBody_ != noSolverBody_)
+            solverBodies_[c->solverBody_].collider = nullptr;
+        if (c->body_)
+            c->body_->collider_ = nullptr;
         if (updating_) {
-            pendingRemovals_.push_back(c);
+            std::erase(movedColliders_, c);
+            std::erase_if(placements_, [c](const Placement& p) { return p.collider == c; });
+            // Moving another collider into the slot now could make the update skip or revisit it.
+            colliders_[c->slot_] = nullptr;
+            pendingRemovals_.push_back(c->slot_);
             return;
         }
-        std::erase(colliders_, c);
-        compact_();
+        swapRemove(colliders_, c->slot_, &Collider::slot_);
+    }
+
+    void CollisionSystem::registerBody(RigidBody* body) {
+        body->slot_ = static_cast<std::uint32_t>(bodies_.size());
+        bodies_.push_back(body);
+        if (body->collider_)
+            body->collider_->body_ = body;
+    }
+
+    void CollisionSystem::unregisterBody(RigidBody* body) {
+        // Bodies are only iterated by stepBodies_, which runs no callbacks, so the slot can be reused right away.
+        if (body->collider_)
+            body->collider_->body_ = nullptr;
+        if (body->state_ != RigidBody::noState_)
+            bodyStates_[body->state_].body = nullptr;
+        swapRemove(bodies_, body->slot_, &RigidBody::slot_);
     }
 
-    void CollisionSystem::update(float) {
+    void CollisionSystem::update(const float dt) {
+        const auto start = Clock::now();
         flushPendingRemovals_();
         updating_ = true;
-        const size_t n = colliders_.size();
-        for (size_t i = 0; i < n; ++i) {
-            Collider* a = colliders_[i];
-            if (!a)
+        ++frame_;
+        stats_.reset();
+        stats_.colliders = colliders_.size();
+
+        if (staticDirty_)
+            rebuildStatic_();
+
+        // Broad phase: refresh every dynamic proxy and collect the pairs whose bounds may overlap.
+        placements_.clear();
+        for (auto* c : colliders_) {
+            if (!c || c->static_)
                 continue;
+            c->sweep_ = c->travelled_();
+            const auto bounds = sweptBounds_(*c);
+            if (const auto* t = c->transform())
+                placements_.push_back(Placement{c, t, t->position, t->rotation, t->scale});
+            if (c->proxy_ == NullProxy)
+                addProxy_(c, bounds);
+            else
+                buckets_[c->bucket_].broadPhase->moveProxy(c->proxy_, bounds);
+        }
 
-            for (size_t j = i + 1; j < n; ++j) {
-                Collider* b = colliders_[j];
-                if (!b)
-                    continue;
+        pairs_.clear();
+        latePairs_.clear();
+        movedColliders_.clear();
+        collectPairs_();
 
-                if ((a->layer() & b->mask()) == 0 || (b->layer() & a->mask()) == 0)
-                    // Layer masks do not align, no collision check needed
+        // Dynamic colliders query the static partition; static vs. static pairs are never generated.
+        if (!static_.empty()) {
+            for (auto* c : colliders_) {
+                if (!c || c->static_)
                     continue;
+                const auto partners = buckets_[c->bucket_].partners;
+                static_.query(Aabb::fromRect(sweptBounds_(*c)), [this, c, partners](Collider* s) {
+                    if ((static_cast<std::uint32_t>(s->layer()) & partners) != 0)
+                        pairs_.push_back(ColliderPair{c, s});
+                });
+            }
+        }
 
-                if (!CheckCollisionRecs(a->axisAlignedWorldBounds(), b->axisAlignedWorldBounds()))
-                    // Broad phase collision check does not succeed, no need for narrow phase.
-                    continue;
+        // Visit pairs in registration order, like the exhaustive loop did, so resolution stays deterministic.
+        for (auto& p : pairs_) {
+            if (p.second->order_ < p.first->order_)
+                std::swap(p.first, p.second);
+        }
+        std::ranges::sort(pairs_, pairBefore_);
 
-                auto m = a->testAgainst(*b);
-                if (!m.colliding)
-                    // Narrow phase collision check does not succeed
-                    continue;
+        stats_.pairs = pairs_.size();
+        const auto broadPhaseEnd = Clock::now();
+
+        matchRecords_();
+        prepareNarrowPhase_();
+
+        nextRecords_.clear();
+        solverContacts_.clear();
+        const auto hasCallbacks = [](const Collider& c) {
+            return c.onCollision_ || c.onCollisionEnter_ || c.onCollisionStay_ ||
+                   c.shape() == ColliderShape::CircleBatch;
+        };
+        std::size_t task = 0;
+        std::size_t late = 0;
+        for (std::size_t next = 0; next < pairs_.size() || late < latePairs_.size();) {
+            // Late pairs have no narrow task nor record; they are tested inline.
+            const bool isLate = late < latePairs_.size() &&
+                                (next == pairs_.size() || pairBefore_(latePairs_[late], pairs_[next]));
+            const auto i = isLate ? pairs_.size() : next;
+            const auto [a, b] = isLate ? latePairs_[late++] : pairs_[next++];
+            while (!isLate && task < narrowTasks_.size() && narrowTasks_[task].pair < i)
+                ++task;
+
+            if ((a->layer() & b->mask()) == 0 || (b->layer() & a->mask()) == 0) {
+                // Layer masks do not align, no collision check needed
+                ++stats_.maskRejected;
+                continue;
+            }
+
+            const bool swept = a->sweeping_() || b->sweeping_();
+            if (!swept && !CheckCollisionRecs(a->axisAlignedWorldBounds(), b->axisAlignedWorldBounds())) {
+                // Broad phase collision check does not succeed, no need for narrow phase.
+                ++stats_.boundsRejected;
+                continue;
+            }
 
-                a->onCollision(b);
-                b->onCollision(a);
+            CollisionManifold m;
+            const auto* previous = swept || isLate ? nullptr : sleeping_(i, *a, *b);
+            if (previous) {
+                // Neither collider changed since the last test: the result cannot have either.
+                m = *previous;
+                ++stats_.narrowReused;
+            }
+            else {
+                const auto shapeA = a->shape();
+                const auto shapeB = b->shape();
+                const auto indexA = static_cast<std::size_t>(shapeA);
+                const auto indexB = static_cast<std::size_t>(shapeB);
+                ++stats_.testsByShape[std::min(indexA, indexB)][std::max(indexA, indexB)];
+                ++stats_.narrowTests;
+                if (!swept && overlapOnly_(*a, *b))
+                    ++stats_.overlapTests;
 
-                resolve_(a, b, m);
+                // Reuse the precomputed manifold unless a callback moved one of the two colliders since.
+                const bool precomputed = task < narrowTasks_.size() && narrowTasks_[task].pair == i &&
+                                         narrowTasks_[task].versionA == a->geometryVersion_ &&
+                                         narrowTasks_[task].versionB == b->geometryVersion_;
+                if (swept)
+                    m = sweptTest_(*a, *b);
+                else if (precomputed)
+                    m = narrowManifolds_[task];
+                else
+                    m = narrowTest_(*a, shapeA, *b, shapeB);
             }
+            if (!swept)
+                nextRecords_.push_back(PairRecord{a->order_, b->order_, a->revision_, b->revision_, m});
+
+            if (!m.colliding)
+                // Narrow phase collision check does not succeed
+                continue;
+
+            ++stats_.contacts;
+            a->onCollision(b);
+            b->onCollision(a);
+            reportBatchHits_(*a, *b);
+            reportBatchHits_(*b, *a);
+            trackContact_(a, b, m);
+            if (hasCallbacks(*a) || hasCallbacks(*b))
+                // The callbacks may have moved any collider; an exhaustive loop would meet it at its new place.
+                recollectMoved_(ColliderPair{a, b});
+            if (a->body_ || b->body_)
+                addBodyContact_(a, b, m, isLate ? noRecord_ : pairRecords_[i]);
+            else
+                addSolverContact_(a, b, m);
         }
+        const auto narrowPhaseEnd = Clock::now();
+
+        stats_.resolved = solverContacts_.size();
+        solveContacts_();
+        stepBodies_(dt);
+        const auto solverEnd = Clock::now();
+
+        records_.swap(nextRecords_);
+        endStaleContacts_();
         updating_ = false;
         flushPendingRemovals_();
+        endSweeps_(colliders_);
+        publishContacts_();
+
+        const auto end = Clock::now();
+        stats_.broadPhaseUs = microseconds(start, broadPhaseEnd);
+        stats_.narrowPhaseUs = microseconds(broadPhaseEnd, narrowPhaseEnd);
+        stats_.solverUs = microseconds(narrowPhaseEnd, solverEnd);
+        stats_.contactEventsUs = microseconds(solverEnd, end);
+        stats_.totalUs = microseconds(start, end);
+
+        timingHistory_[0][historyOffset_] = stats_.broadPhaseUs;
+        timingHistory_[1][historyOffset_] = stats_.narrowPhaseUs;
+        timingHistory_[2][historyOffset_] = stats_.solverUs;
+        timingHistory_[3][historyOffset_] = stats_.totalUs;
+        historyOffset_ = (historyOffset_ + 1) % statsHistory_;
+    }
+
+    void CollisionSystem::setEventBus(EventBus* events) {
+        events_ = events;
+    }
+
+    std::size_t CollisionSystem::contactCount() const { return contacts_.size(); }
+
+    void CollisionSystem::setBroadPhase(const BroadPhaseType type) {
+        if (type == broadPhaseType_)
+            return;
+
+        broadPhaseType_ = type;
+        buckets_.clear();
+        for (auto* c : colliders_) {
+            if (c)
+                c->proxy_ = NullProxy;
+        }
+    }
+
+    BroadPhaseType CollisionSystem::broadPhase() const { return broadPhaseType_; }
+
+    void CollisionSystem::setBroadPhaseConfig(const BroadPhaseConfig& config) {
+        broadPhaseConfig_ = config;
+        for (auto& bucket : buckets_) {
+            bucket.broadPhase->configure(broadPhaseConfig_);
+        }
+    }
+
+    const BroadPhaseConfig& CollisionSystem::broadPhaseConfig() const { return broadPhaseConfig_; }
+
+    void CollisionSystem::setCellSize(const float cellSize) {
+        auto config = broadPhaseConfig_;
+        config.cellSize = cellSize;
+        setBroadPhaseConfig(config);
+    }
+
+    float CollisionSystem::cellSize() const { return broadPhaseConfig_.cellSize; }
+
+    void CollisionSystem::setWorkerThreads(const unsigned count) {
+        if (count == workerThreads_)
+            return;
+        workerThreads_ = count;
+        workers_.reset();
+    }
+
+    unsigned CollisionSystem::workerThreads() const { return workerThreads_; }
+
+    void CollisionSystem::setSolverConfig(const SolverConfig& config) {
+        solverConfig_ = config;
+        solverConfig_.iterations = std::max(solverConfig_.iterations, 1);
+    }
+
+    const SolverConfig& CollisionSystem::solverConfig() const { return solverConfig_; }
+
+    void CollisionSystem::setPhysicsConfig(const PhysicsConfig& config) {
+        physicsConfig_ = config;
+        physicsConfig_.iterations = std::max(physicsConfig_.iterations, 1);
+        physicsConfig_.maxSubsteps = std::max(physicsConfig_.maxSubsteps, 1);
+    }
+
+    const PhysicsConfig& CollisionSystem::physicsConfig() const { return physicsConfig_; }
+
+    const CollisionStats& CollisionSystem::stats() const { return stats_; }
+
+    void CollisionSystem::setLayersInteract(const ColliderLayerMask a, const ColliderLayerMask b, const bool interact) {
+        const auto bitsA = static_cast<std::uint32_t>(a);
+        const auto bitsB = static_cast<std::uint32_t>(b);
+        for (unsigned i = 0; i < colliderLayerCount; ++i) {
+            for (unsigned j = 0; j < colliderLayerCount; ++j) {
+                if ((bitsA >> i & 1u) == 0 || (bitsB >> j & 1u) == 0)
+                    continue;
+                if (interact) {
+                    layerMatrix_[i] |= 1u << j;
+                    layerMatrix_[j] |= 1u << i;
+                }
+                else {
+                    layerMatrix_[i] &= ~(1u << j);
+                    layerMatrix_[j] &= ~(1u << i);
+                }
+            }
+        }
+    }
+
+    bool CollisionSystem::layersInteract(const ColliderLayerMask a, const ColliderLayerMask b) const {
+        return (partners_(a) & static_cast<std::uint32_t>(b)) != 0;
+    }
+
+    std::uint32_t CollisionSystem::partners_(const ColliderLayerMask layer) const {
+        std::uint32_t partners = 0;
+        for (auto bits = static_cast<std::uint32_t>(layer); bits != 0; bits &= bits - 1) {
+            partners |= layerMatrix_[std::countr_zero(bits)];
+        }
+        return partners;
+    }
+
+    void CollisionSystem::addProxy_(Collider* c, const Rectangle& bounds) {
+        auto bucket = std::ranges::find(buckets_, c->layer(), &LayerBucket::layer);
+        if (bucket == buckets_.end()) {
+            buckets_.push_back(LayerBucket{c->layer(), makeBroadPhase(broadPhaseType_, broadPhaseConfig_), {}});
+            bucket = buckets_.end() - 1;
+        }
+        c->bucket_ = static_cast<std::uint32_t>(bucket - buckets_.begin());
+        c->bucketSlot_ = static_cast<std::uint32_t>(bucket->colliders.size());
+        bucket->colliders.push_back(c);
+        c->proxy_ = bucket->broadPhase->createProxy(c, bounds);
+    }
+
+    void CollisionSystem::removeProxy_(Collider* c) {
+        auto& bucket = buckets_[c->bucket_];
+        bucket.broadPhase->destroyProxy(c->proxy_);
+        c->proxy_ = NullProxy;
+        swapRemove(bucket.colliders, c->bucketSlot_, &Collider::bucketSlot_);
+    }
+
+    void CollisionSystem::collectPairs_() {
+        for (auto& bucket : buckets_) {
+            bucket.partners = partners_(bucket.layer);
+            if ((static_cast<std::uint32_t>(bucket.layer) & bucket.partners) != 0)
+                bucket.broadPhase->collectPairs(pairs_);
+            else
+                // Never paired with itself, but other buckets may still query it
+                bucket.broadPhase->refresh();
+        }
+
+        // Across buckets, the colliders of the smaller one query the broad phase of the larger one.
+        for (std::size_t i = 0; i < buckets_.size(); ++i) {
+            for (auto j = i + 1; j < buckets_.size(); ++j) {
+                if ((static_cast<std::uint32_t>(buckets_[j].layer) & buckets_[i].partners) == 0)
+                    continue;
+                const bool iSmaller = buckets_[i].colliders.size() <= buckets_[j].colliders.size();
+                const auto& small = iSmaller ? buckets_[i] : buckets_[j];
+                const auto& large = iSmaller ? buckets_[j] : buckets_[i];
+                for (auto* c : small.colliders) {
+                    queryCandidates_.clear();
+                    large.broadPhase->query(Aabb::fromRect(sweptBounds_(*c)), queryCandidates_);
+                    for (auto* other : queryCandidates_) {
+                        pairs_.push_back(ColliderPair{c, other});
+                    }
+                }
+            }
+        }
+    }
+
+    bool CollisionSystem::pairBefore_(const ColliderPair& l, const ColliderPair& r) {
+        if (l.first->order_ != r.first->order_)
+            return l.first->order_ < r.first->order_;
+        return l.second->order_ < r.second->order_;
+    }
+
+    void CollisionSystem::recollectMoved_(const ColliderPair& current) {
+        for (auto& p : placements_) {
+            const auto* t = p.transform;
+            if (t->position.x == p.position.x && t->position.y == p.position.y && t->rotation == p.rotation &&
+                t->scale.x == p.scale.x && t->scale.y == p.scale.y)
+                continue;
+            p.position = t->position;
+            p.rotation = t->rotation;
+            p.scale = t->scale;
+            recollect_(*p.collider, current);
+        }
+    }
+
+    void CollisionSystem::recollect_(Collider& c, const ColliderPair& current) {
+        // Candidates were collected from the bounds each collider had when the update began. Once a callback
+        // moves one, its pairs still to be visited are collected again, so they match what an exhaustive loop
+        // would see. Pairs up to `current` were visited already and are left alone.
+        if (std::ranges::find(movedColliders_, &c) == movedColliders_.end())
+            movedColliders_.push_back(&c);
+
+        // Current bounds, widened back to where a continuous collider began its motion
+        const auto bounds = c.axisAlignedWorldBounds();
+        const auto travelled = c.travelled_();
+        const auto box = Aabb::fromRect(Rectangle{std::min(bounds.x, bounds.x - travelled.x),
+                                                  std::min(bounds.y, bounds.y - travelled.y),
+                                                  bounds.width + std::fabs(travelled.x),
+                                                  bounds.height + std::fabs(travelled.y)});
+        const auto partners = buckets_[c.bucket_].partners;
+        const auto partner = [partners](const Collider* other) {
+            return (static_cast<std::uint32_t>(other->layer()) & partners) != 0;
+        };
+
+        queryCandidates_.clear();
+        for (const auto& bucket : buckets_) {
+            if ((static_cast<std::uint32_t>(bucket.layer) & partners) != 0)
+                bucket.broadPhase->query(box, queryCandidates_);
+        }
+        if (staticDirty_)
+            // The partition may still point at a destroyed static collider
+            rebuildStatic_();
+        static_.query(box, [this, &partner](Collider* s) {
+            if (partner(s))
+                queryCandidates_.push_back(s);
+        });
+        // The proxies of colliders moved earlier in this update are stale, so those are always candidates.
+        for (auto* other : movedColliders_) {
+            if (partner(other))
+                queryCandidates_.push_back(other);
+        }
+
+        for (auto* other : queryCandidates_) {
+            if (other == &c)
+                continue;
+            const auto pair = c.order_ < other->order_ ? ColliderPair{&c, other} : ColliderPair{other, &c};
+            if (!pairBefore_(current, pair) || std::ranges::binary_search(pairs_, pair, pairBefore_))
+                continue;
+            const auto at = std::ranges::lower_bound(latePairs_, pair, pairBefore_);
+            if (at != latePairs_.end() && !pairBefore_(pair, *at))
+                continue;
+            latePairs_.insert(at, pair);
+            ++stats_.pairs;
+        }
+    }
+
+    void CollisionSystem::invalidateStatic() {
+        staticDirty_ = true;
+    }
+
+    template <typename Fn>
+    void CollisionSystem::forEachCandidate_(const Aabb& box, const QueryFilter& filter, Fn&& fn) {
+        if (staticDirty_)
+            // The partition may still point at a destroyed static collider
+            rebuildStatic_();
+
+        queryCandidates_.clear();
+        for (const auto& bucket : buckets_) {
+            if ((bucket.layer & filter.mask) != 0)
+                bucket.broadPhase->query(box, queryCandidates_);
+        }
+        static_.query(box, [this](Collider* c) { queryCandidates_.push_back(c); });
+        std::ranges::sort(queryCandidates_, {}, [](const Collider* c) { return c->order_; });
+
+        for (auto* c : queryCandidates_) {
+            if (c == filter.ignore || (c->layer() & filter.mask) == 0 || (!filter.triggers && c->isTrigger()))
+                continue;
+            if (!fn(c))
+                return;
+        }
+    }
+
+    std::size_t CollisionSystem::queryPoint(const Vector2 point, const std::span<Collider*> out,
+                                            const QueryFilter& filter) {
+        const ConvexSupport probe{std::span(&point, 1), 0.0f, point};
+        std::size_t count = 0;
+        forEachCandidate_(Aabb{point.x, point.y, point.x, point.y}, filter, [&](Collider* c) {
+            if (count == out.size())
+                return false;
+            if (c->overlaps(probe))
+                out[count++] = c;
+            return true;
+        });
+        return count;
+    }
+
+    std::size_t CollisionSystem::queryCircle(const Vector2 center, const float radius, const std::span<Collider*> out,
+                                             const QueryFilter& filter) {
+        const ConvexSupport probe{std::span(&center, 1), radius, center};
+        std::size_t count = 0;
+        forEachCandidate_(Aabb{center.x - radius, center.y - radius, center.x + radius, center.y + radius}, filter,
+                         [&](Collider* c) {
+                             if (count == out.size())
+                                 return false;
+                             if (c->overlaps(probe))
+                                 out[count++] = c;
+                             return true;
+                         });
+        return count;
+    }
+
+    std::size_t CollisionSystem::queryRect(const Rectangle& rect, const std::span<Collider*> out,
+                                           const QueryFilter& filter) {
+        const std::array corners{Vector2{rect.x, rect.y}, Vector2{rect.x + rect.width, rect.y},
+                                 Vector2{rect.x + rect.width, rect.y + rect.height},
+                                 Vector2{rect.x, rect.y + rect.height}};
+        const ConvexSupport probe{corners, 0.0f, Vector2{rect.x + rect.width * 0.5f, rect.y + rect.height * 0.5f}};
+        std::size_t count = 0;
+        forEachCandidate_(Aabb::fromRect(rect), filter, [&](Collider* c) {
+            if (count == out.size())
+                return false;
+            if (c->overlaps(probe))
+                out[count++] = c;
+            return true;
+        });
+        return count;
+    }
+
+    bool CollisionSystem::castFirst_(const ConvexSupport& shape, const Aabb& box, const Vector2 motion, CastHit& hit,
+                                     const QueryFilter& filter) {
+        bool found = false;
+        forEachCandidate_(box, filter, [&](Collider* c) {
+            CastHit candidate;
+            if (!c->castAgainst(shape, motion, candidate))
+                return true;
+            if (!found || candidate.fraction < hit.fraction) {
+                hit = candidate;
+                hit.collider = c;
+                found = true;
+            }
+            return true;
+        });
+        return found;
+    }
+
+    bool CollisionSystem::raycast(const Vector2 from, const Vector2 to, CastHit& hit, const QueryFilter& filter) {
+        const ConvexSupport ray{std::span(&from, 1), 0.0f, from};
+        const Aabb box{std::min(from.x, to.x), std::min(from.y, to.y), std::max(from.x, to.x), std::max(from.y, to.y)};
+        return castFirst_(ray, box, Vector2Subtract(to, from), hit, filter);
+    }
+
+    std::size_t CollisionSystem::raycastAll(const Vector2 from, const Vector2 to, const std::span<CastHit> out,
+                                            const QueryFilter& filter) {
+        if (out.empty())
+            return 0;
+
+        const ConvexSupport ray{std::span(&from, 1), 0.0f, from};
+        const auto motion = Vector2Subtract(to, from);
+        const Aabb box{std::min(from.x, to.x), std::min(from.y, to.y), std::max(from.x, to.x), std::max(from.y, to.y)};
+        std::size_t count = 0;
+        forEachCandidate_(box, filter, [&](Collider* c) {
+            CastHit hit;
+            if (!c->castAgainst(ray, motion, hit))
+                return true;
+            hit.collider = c;
+            if (count == out.size() && hit.fraction >= out[count - 1].fraction)
+                return true;
+
+            // Insertion into the sorted buffer; a full buffer drops its furthest hit.
+            auto i = count < out.size() ? count++ : count - 1;
+            for (; i > 0 && out[i - 1].fraction > hit.fraction; --i) {
+                out[i] = out[i - 1];
+            }
+            out[i] = hit;
+            return true;
+        });
+        return count;
+    }
+
+    bool CollisionSystem::circleCast(const Vector2 center, const float radius, const Vector2 motion, CastHit& hit,
+                                     const QueryFilter& filter) {
+        const ConvexSupport circle{std::span(&center, 1), radius, center};
+        const auto end = Vector2Add(center, motion);
+        const Aabb box{std::min(center.x, end.x) - radius, std::min(center.y, end.y) - radius,
+                       std::max(center.x, end.x) + radius, std::max(center.y, end.y) + radius};
+        return castFirst_(circle, box, motion, hit, filter);
+    }
+
+    bool CollisionSystem::shapeCast(const Collider& shape, const Vector2 motion, CastHit& hit, QueryFilter filter) {
+        filter.ignore = &shape;
+        const auto start = Aabb::fromRect(shape.axisAlignedWorldBounds());
+        const Aabb end{start.minX + motion.x, start.minY + motion.y, start.maxX + motion.x, start.maxY + motion.y};
+        return castFirst_(shape.convexSupport(), Aabb::merge(start, end), motion, hit, filter);
+    }
+
+    void CollisionSystem::staticChanged_(Collider* c) {
+        c->sweep_ = Vector2{0.0f, 0.0f}; // static colliders are never swept
+        c->geometryValid_ = false; // wakes its pairs; whether the solver moves it decides how they are tested
+        if (c->static_) {
+            if (c->proxy_ != NullProxy)
+                removeProxy_(c);
+            c->staticSlot_ = static_cast<std::uint32_t>(staticColliders_.size());
+            staticColliders_.push_back(c);
+        }
+        else {
+            // The dynamic proxy is created again on the next update.
+            swapRemove(staticColliders_, c->staticSlot_, &Collider::staticSlot_);
+        }
+        staticDirty_ = true;
+    }
+
+    void CollisionSystem::rebuildStatic_() {
+        static_.build(staticColliders_);
+        staticDirty_ = false;
     }
 
     void CollisionSystem::setDebug(const bool debug) {
@@ -68,71 +716,740 @@ namespace rlge {
 
         if (ImGui::Begin("Collisions")) {
             ImGui::Checkbox("Draw colliders", &debug_);
+            ImGui::Text("Colliders: %zu (%zu static, %zu layer buckets)", colliders_.size(), staticColliders_.size(),
+                        buckets_.size());
+
+            static constexpr const char* broadPhaseNames[] = {"Spatial hash", "Dynamic tree", "Sweep and prune",
+                                                               "Box pruning (SIMD)"};
+            auto type = static_cast<int>(broadPhaseType_);
+            if (ImGui::Combo("Broad phase", &type, broadPhaseNames, IM_ARRAYSIZE(broadPhaseNames)))
+                setBroadPhase(static_cast<BroadPhaseType>(type));
+
+            auto config = broadPhaseConfig_;
+            bool changed = false;
+            if (broadPhaseType_ == BroadPhaseType::SpatialHash) {
+                changed |= ImGui::SliderFloat("Cell size", &config.cellSize, 8.0f, 512.0f);
+            }
+            else if (broadPhaseType_ == BroadPhaseType::DynamicTree) {
+                changed |= ImGui::SliderFloat("Fat margin", &config.treeMargin, 0.0f, 64.0f);
+            }
+            if (changed)
+                setBroadPhaseConfig(config);
+
+            if (ImGui::CollapsingHeader("Profiler", ImGuiTreeNodeFlags_DefaultOpen)) {
+                ImGui::Text("Pairs: %zu (%zu layer mask, %zu bounds rejected)", stats_.pairs, stats_.maskRejected,
+                            stats_.boundsRejected);
+                ImGui::Text("Narrow phase: %zu tested (%zu overlap only), %zu asleep", stats_.narrowTests,
+                            stats_.overlapTests, stats_.narrowReused);
+                ImGui::Text("Contacts: %zu (%zu resolved)", stats_.contacts, stats_.resolved);
+
+                static constexpr const char* shapeNames[colliderShapeCount] = {"Box", "Circle", "OBB", "Polygon",
+                                                                                "Capsule", "Tile grid",
+                                                                                "Circle batch", "Compound"};
+                for (std::size_t low = 0; low < colliderShapeCount; ++low) {
+                    for (std::size_t high = low; high < colliderShapeCount; ++high) {
+                        if (const auto tests = stats_.testsByShape[low][high])
+                            ImGui::BulletText("%s / %s: %zu", shapeNames[low], shapeNames[high], tests);
+                    }
+                }
+
+                static constexpr const char* stageNames[] = {"Broad phase", "Narrow phase", "Solver", "Total"};
+                for (std::size_t stage = 0; stage < timingHistory_.size(); ++stage) {
+                    const auto& history = timingHistory_[stage];
+                    const auto latest = history[(historyOffset_ + statsHistory_ - 1) % statsHistory_];
+                    char label[48];
+                    std::snprintf(label, sizeof(label), "%s: %.0f us", stageNames[stage], latest);
+                    ImGui::PushID(static_cast<int>(stage));
+                    ImGui::PlotLines("", history.data(), static_cast<int>(statsHistory_),
+                                     static_cast<int>(historyOffset_), label, 0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+                    ImGui::PopID();
+                }
+            }
+
+            auto solver = solverConfig_;
+            bool solverChanged = ImGui::SliderInt("Solver iterations", &solver.iterations, 1, 16);
+            solverChanged |= ImGui::SliderFloat("Slop", &solver.slop, 0.0f, 1.0f);
+            solverChanged |= ImGui::SliderFloat("Baumgarte", &solver.baumgarte, 0.1f, 1.0f);
+            if (solverChanged)
+                setSolverConfig(solver);
+            ImGui::Text("Solver: %zu contacts", solverContacts_.size());
+
+            auto physics = physicsConfig_;
+            bool physicsChanged = ImGui::SliderInt("Body iterations", &physics.iterations, 1, 16);
+            physicsChanged |= ImGui::SliderFloat2("Gravity", &physics.gravity.x, -2000.0f, 2000.0f);
+            physicsChanged |= ImGui::SliderFloat("Sleep speed", &physics.sleepSpeed, 0.0f, 50.0f);
+            if (physicsChanged)
+                setPhysicsConfig(physics);
+            ImGui::Text("Bodies: %zu of %zu awake, %zu contacts, %zu substeps", stats_.bodies, bodies_.size(),
+                        stats_.bodyContacts, stats_.substeps);
+
+            auto threads = static_cast<int>(workerThreads_);
+            if (ImGui::SliderInt("Worker threads", &threads, 0, static_cast<int>(std::thread::hardware_concurrency())))
+                setWorkerThreads(static_cast<unsigned>(threads));
         }
         ImGui::End();
     }
 
-    void CollisionSystem::compact_() {
-        std::erase(colliders_, nullptr);
-    }
-
     void CollisionSystem::flushPendingRemovals_() {
         if (pendingRemovals_.empty())
             return;
-        for (auto* c : pendingRemovals_) {
-            std::erase(colliders_, c);
+        // Highest slot first: every slot above the one being removed is then occupied, so the entry moved into
+        // it is never another pending one.
+        std::ranges::sort(pendingRemovals_, std::greater{});
+        for (const auto slot : pendingRemovals_) {
+            swapRemove(colliders_, slot, &Collider::slot_);
         }
         pendingRemovals_.clear();
-        compact_();
     }
 
-    void CollisionSystem::resolve_(Collider* a, Collider* b, const CollisionManifold& manifold) {
-        const auto typeA = a->type();
-        const auto typeB = b->type();
+    void CollisionSystem::matchRecords_() {
+        // Both lists are sorted by registration sequence, so one merge pass pairs them up.
+        pairRecords_.assign(pairs_.size(), noRecord_);
+        std::size_t r = 0;
+        for (std::size_t i = 0; i < pairs_.size() && r < records_.size(); ++i) {
+            const auto a = pairs_[i].first->order_;
+            const auto b = pairs_[i].second->order_;
+            while (r < records_.size() && (records_[r].a < a || (records_[r].a == a && records_[r].b < b)))
+                ++r;
+            if (r < records_.size() && records_[r].a == a && records_[r].b == b)
+                pairRecords_[i] = static_cast<std::uint32_t>(r);
+        }
+    }
 
-        const bool triggerA = a->isTrigger();
-        const bool triggerB = b->isTrigger();
+    const CollisionManifold* CollisionSystem::sleeping_(const std::size_t pair, const Collider& a,
+                                                        const Collider& b) const {
+        const auto index = pairRecords_[pair];
+        if (index == noRecord_)
+            return nullptr;
+        const auto& record = records_[index];
+        if (record.revisionA != a.revision_ || record.revisionB != b.revision_)
+            return nullptr;
+        return &record.manifold;
+    }
 
-        // If both are triggers, nothing to resolve.
-        if (triggerA && triggerB)
+    void CollisionSystem::prepareNarrowPhase_() {
+        narrowTasks_.clear();
+        narrowManifolds_.clear();
+        if (workerThreads_ == 0)
             return;
 
-        const bool solidA = (typeA == ColliderType::Solid);
-        const bool solidB = (typeB == ColliderType::Solid);
-        const bool kinA   = (typeA == ColliderType::Kinematic);
-        const bool kinB   = (typeB == ColliderType::Kinematic);
-
-        // Static / kinematic vs. solid: move only the solid collider fully out of penetration.
-        if (kinA && solidB && !triggerB) {
-            CollisionManifold mb = manifold;
-            // For B we normally flip the normal; do the same here but double the depth
-            mb.normal = Vector2Negate(mb.normal);
-            mb.depth *= 2.0f; // default resolve moves by depth * 0.5
-            b->resolve(mb);
+        for (std::size_t i = 0; i < pairs_.size(); ++i) {
+            const auto [a, b] = pairs_[i];
+            if ((a->layer() & b->mask()) == 0 || (b->layer() & a->mask()) == 0)
+                continue;
+            if (a->sweeping_() || b->sweeping_())
+                continue;
+            // Refreshes both geometry caches here, so the workers only ever read them.
+            if (!CheckCollisionRecs(a->axisAlignedWorldBounds(), b->axisAlignedWorldBounds()))
+                continue;
+            if (!isHeavyPair(*a, *b) || sleeping_(i, *a, *b))
+                continue;
+            narrowTasks_.push_back(NarrowTask{static_cast<std::uint32_t>(i), a->geometryVersion_, b->geometryVersion_});
+        }
+
+        if (narrowTasks_.size() < minParallelTasks_) {
+            // Not worth waking the pool; the pair loop tests these inline.
+            narrowTasks_.clear();
             return;
         }
 
-        if (kinB && solidA && !triggerA) {
-            CollisionManifold ma = manifold;
-            ma.depth *= 2.0f; // default resolve moves by depth * 0.5
-            a->resolve(ma);
+        if (!workers_)
+            workers_ = std::make_unique<WorkerPool>(workerThreads_);
+
+        // Each slot takes a contiguous range of tasks into its own buffer; concatenating the buffers in slot
+        // order keeps the results in pair order.
+        const auto slots = workers_->slots();
+        narrowBuffers_.resize(slots);
+        workers_->run([this, slots](const unsigned slot) {
+            const auto count = narrowTasks_.size();
+            const auto begin = count * slot / slots;
+            const auto end = count * (slot + 1) / slots;
+            auto& out = narrowBuffers_[slot];
+            out.clear();
+            for (auto t = begin; t < end; ++t) {
+                const auto& p = pairs_[narrowTasks_[t].pair];
+                out.push_back(narrowTest_(*p.first, p.first->shape(), *p.second, p.second->shape()));
+            }
+        });
+
+        narrowManifolds_.reserve(narrowTasks_.size());
+        for (std::size_t slot = 0; slot < slots; ++slot) {
+            narrowManifolds_.insert(narrowManifolds_.end(), narrowBuffers_[slot].begin(), narrowBuffers_[slot].end());
+        }
+    }
+
+    void CollisionSystem::endSweeps_(const std::vector<Collider*>& colliders) {
+        // Resolution has settled every position; the next sweep starts from here.
+        for (auto* c : colliders) {
+            if (!c || !c->continuous_)
+                continue;
+            const auto* t = c->transform();
+            c->sweepValid_ = t != nullptr;
+            c->sweepStart_ = t ? t->position : Vector2{0.0f, 0.0f};
+        }
+    }
+
+    Rectangle CollisionSystem::sweptBounds_(const Collider& c) {
+        const auto bounds = c.axisAlignedWorldBounds();
+        if (!c.sweeping_())
+            return bounds;
+        // Union of the bounds at the start and at the end of the motion
+        return Rectangle{std::min(bounds.x, bounds.x - c.sweep_.x), std::min(bounds.y, bounds.y - c.sweep_.y),
+                         bounds.width + std::fabs(c.sweep_.x), bounds.height + std::fabs(c.sweep_.y)};
+    }
+
+    CollisionManifold CollisionSystem::sweptTest_(const Collider& a, const Collider& b) {
+        // Shapes at their start positions: circles keep their radius, everything else becomes its bounds.
+        // The motion is taken again here, since a callback of an earlier pair may have moved either collider.
+        const auto travelledA = a.travelled_();
+        const auto travelledB = b.travelled_();
+        const auto start = [](const Collider& c, const Vector2 travelled) {
+            const auto support = c.convexSupport();
+            const auto bounds = c.axisAlignedWorldBounds();
+            narrow_phase::SweptShape s{
+                Rectangle{bounds.x - travelled.x, bounds.y - travelled.y, bounds.width, bounds.height},
+                Vector2Subtract(support.center, travelled), 0.0f};
+            if (support.core.size() == 1)
+                s.radius = support.radius;
+            return s;
+        };
+
+        // Casts the exact shape of `mover` through `target`, both where they stood when the frame began: the
+        // mover is moved back by their relative motion, the target is read at its current position.
+        const auto exactCast = [this](const Collider& mover, const Collider& target, const Vector2 relative,
+                                      CastHit& hit) {
+            const auto support = mover.convexSupport();
+            sweptCore_.resize(support.core.size());
+            for (std::size_t i = 0; i < support.core.size(); ++i) {
+                sweptCore_[i] = Vector2Subtract(support.core[i], relative);
+            }
+            const ConvexSupport moved{sweptCore_, support.radius, Vector2Subtract(support.center, relative)};
+            return target.castAgainst(moved, relative, hit);
+        };
+
+        const auto motion = Vector2Subtract(travelledA, travelledB);
+        const auto entered = [motion](const CastHit& hit, const Vector2 normal) {
+            CollisionManifold m;
+            m.colliding = true;
+            m.toi = hit.fraction;
+            m.normal = normal;
+            m.depth = std::max(0.0f, Vector2DotProduct(Vector2Scale(motion, 1.0f - hit.fraction), normal));
+            return m;
+        };
+        const auto pieces = [](const Collider& c) {
+            return c.shape() == ColliderShape::TileGrid || c.shape() == ColliderShape::CircleBatch ||
+                   c.shape() == ColliderShape::Compound;
+        };
+
+        CollisionManifold ccd;
+        if (!pieces(a) && !pieces(b)) {
+            // The bounds sweep is cheap and never misses a contact, but boxes around rotated or polygonal shapes
+            // also report near misses; the exact shapes have to agree.
+            ccd = narrow_phase::timeOfImpact(start(a, travelledA), start(b, travelledB), motion);
+            if (ccd.colliding) {
+                CastHit hit;
+                if (!exactCast(a, b, motion, hit))
+                    ccd = CollisionManifold{};
+                else if (hit.fraction > 0.0f)
+                    ccd = entered(hit, Vector2Negate(hit.normal));
+                // Touching when the frame began, the cast has no contact normal yet; the bounds face is kept.
+            }
+        }
+        else if (!pieces(a) || !pieces(b)) {
+            // The convex side is cast through the grid's tiles, the batch's circles or the compound's children.
+            CastHit hit;
+            const bool moverA = !pieces(a);
+            if (moverA ? exactCast(a, b, motion, hit) : exactCast(b, a, Vector2Negate(motion), hit))
+                // hit.normal faces the mover; the manifold's points from a to b
+                ccd = entered(hit, moverA ? Vector2Negate(hit.normal) : hit.normal);
+        }
+        else {
+            // Both are made of pieces: only the bounds of b can be cast through a's pieces. That is not exact
+            // enough on its own, so the contact also needs the discrete test to overlap.
+            if (!a.testOverlap(b))
+                return CollisionManifold{};
+            const auto bounds = b.axisAlignedWorldBounds();
+            const Rectangle r{bounds.x + motion.x, bounds.y + motion.y, bounds.width, bounds.height};
+            const std::array corners{Vector2{r.x, r.y}, Vector2{r.x + r.width, r.y},
+                                     Vector2{r.x + r.width, r.y + r.height}, Vector2{r.x, r.y + r.height}};
+            CastHit hit;
+            if (a.castAgainst(ConvexSupport{corners, 0.0f, Vector2{r.x + r.width * 0.5f, r.y + r.height * 0.5f}},
+                              Vector2Negate(motion), hit))
+                ccd = entered(hit, hit.normal);
+        }
+        if (ccd.colliding && (a.shape() == ColliderShape::CircleBatch || b.shape() == ColliderShape::CircleBatch)) {
+            // Like its other manifolds, only that a circle was crossed
+            ccd.normal = Vector2{0.0f, 0.0f};
+            ccd.depth = 0.0f;
+        }
+
+        // A contact entered during the frame is pushed back along its entry normal: the discrete manifold of a
+        // fast mover that ended past a thin wall's middle points out of the far side. Overlaps the sweep saw no
+        // entry for keep their exact discrete manifold.
+        if (ccd.colliding && ccd.toi < 1.0f)
+            return ccd;
+        auto m = a.testAgainst(b);
+        if (!m.colliding)
+            return ccd;
+        if (ccd.colliding)
+            m.toi = ccd.toi;
+        return m;
+    }
+
+    bool CollisionSystem::movable_(const Collider& c) {
+        return c.type() == ColliderType::Solid && !c.isStatic() && !c.isTrigger();
+    }
+
+    bool CollisionSystem::overlapOnly_(const Collider& a, const Collider& b) {
+        return (a.isTrigger() || b.isTrigger()) && !movable_(a) && !movable_(b);
+    }
+
+    void CollisionSystem::reportBatchHits_(const Collider& batch, const Collider& other) {
+        if (batch.shape() == ColliderShape::CircleBatch)
+            static_cast<const CircleBatchCollider&>(batch).reportHits_(other);
+    }
+
+    CollisionManifold CollisionSystem::narrowTest_(const Collider& a, const ColliderShape shapeA, const Collider& b,
+                                                   const ColliderShape shapeB) {
+        // Nothing resolves these contacts, so only whether the shapes touch is worth computing.
+        if (overlapOnly_(a, b)) {
+            CollisionManifold m;
+            const auto direct = overlapDirect(a, shapeA, b, shapeB);
+            m.colliding = direct ? *direct : a.testOverlap(b);
+            return m;
+        }
+        if (auto direct = testDirect(a, shapeA, b, shapeB))
+            return *direct;
+        return a.testAgainst(b);
+    }
+
+    void CollisionSystem::trackContact_(Collider* a, Collider* b, const CollisionManifold& manifold) {
+        // Pairs arrive ordered by registration sequence, so (a, b) is already a canonical key.
+        const auto [it, inserted] =
+            contacts_.try_emplace(ContactKey{a->order_, b->order_}, Contact{a, b, manifold, frame_});
+        if (inserted) {
+            ++a->contacts_;
+            ++b->contacts_;
+            entered_.push_back(ContactEvent{a, b, manifold});
+            a->onCollisionEnter(b);
+            b->onCollisionEnter(a);
             return;
         }
+        it->second.manifold = manifold;
+        it->second.frame = frame_;
+        stayed_.push_back(ContactEvent{a, b, manifold});
+        a->onCollisionStay(b);
+        b->onCollisionStay(a);
+    }
 
-        // Solid vs. solid: symmetric resolution as before.
-        if (solidA && solidB) {
-            if (!triggerA) {
-                a->resolve(manifold);
+    void CollisionSystem::endStaleContacts_() {
+        // Erase first and notify afterwards, so exit callbacks may freely destroy colliders.
+        const auto firstExit = exited_.size();
+        for (auto it = contacts_.begin(); it != contacts_.end();) {
+            if (it->second.frame == frame_) {
+                ++it;
+                continue;
             }
-            if (!triggerB) {
-                CollisionManifold flipped = manifold;
-                flipped.normal = Vector2Negate(flipped.normal);
-                b->resolve(flipped);
+            auto& [a, b, manifold, frame, impulse] = it->second;
+            --a->contacts_;
+            --b->contacts_;
+            exited_.push_back(ContactEvent{a, b, manifold});
+            it = contacts_.erase(it);
+        }
+        // Hash order is arbitrary; report exits in pair order like everything else.
+        std::ranges::sort(exited_.begin() + static_cast<std::ptrdiff_t>(firstExit), exited_.end(),
+                          [](const ContactEvent& l, const ContactEvent& r) {
+                              if (l.a->order_ != r.a->order_)
+                                  return l.a->order_ < r.a->order_;
+                              return l.b->order_ < r.b->order_;
+                          });
+        // Index loop: a callback that destroys a collider appends to exited_.
+        for (auto i = firstExit; i < exited_.size(); ++i) {
+            if (exited_[i].a && exited_[i].b)
+                exited_[i].a->onCollisionExit(exited_[i].b);
+            if (exited_[i].a && exited_[i].b)
+                exited_[i].b->onCollisionExit(exited_[i].a);
+        }
+    }
+
+    void CollisionSystem::dropContacts_(Collider* c) {
+        // The collider is going away: end its contacts now, so partners never see a dangling pointer later on.
+        std::vector<Collider*> partners;
+        for (auto it = contacts_.begin(); it != contacts_.end();) {
+            auto& [a, b, manifold, frame, impulse] = it->second;
+            if (a != c && b != c) {
+                ++it;
+                continue;
             }
+            auto* other = a == c ? b : a;
+            --other->contacts_;
+            exited_.push_back(ContactEvent{other, nullptr, manifold});
+            partners.push_back(other);
+            it = contacts_.erase(it);
+        }
+        c->contacts_ = 0;
+
+        // Batched events must not hand out the pointer either.
+        const auto involves = [c](const ContactEvent& e) { return e.a == c || e.b == c; };
+        std::erase_if(entered_, involves);
+        std::erase_if(stayed_, involves);
+        for (auto& e : exited_) {
+            if (e.a == c)
+                std::swap(e.a, e.b);
+            if (e.b == c)
+                e.b = nullptr;
         }
 
-        // Other combinations (sensors, triggers vs solids, kinematic vs kinematic)
-        // are left to user code via callbacks only.
+        for (auto* other : partners) {
+            other->onCollisionExit(c);
+        }
+    }
+
+    void CollisionSystem::publishContacts_() {
+        // Contacts whose colliders were both destroyed this frame have nobody left to report to.
+        std::erase_if(exited_, [](const ContactEvent& e) { return e.a == nullptr; });
+        if (events_ && (!entered_.empty() || !stayed_.empty() || !exited_.empty()))
+            events_->publish(CollisionContactsEvent{entered_, stayed_, exited_});
+        entered_.clear();
+        stayed_.clear();
+        exited_.clear();
+    }
+
+    void CollisionSystem::addSolverContact_(Collider* a, Collider* b, const CollisionManifold& manifold) {
+        // Solid colliders are pushed out; static and kinematic ones push without being moved. Triggers never
+        // move, and contacts where neither side can are left to user code via callbacks only.
+        const auto body = [this](Collider* c) {
+            if (!movable_(*c))
+                return noSolverBody_;
+            if (c->solverBody_ == noSolverBody_) {
+                c->solverBody_ = static_cast<std::uint32_t>(solverBodies_.size());
+                solverBodies_.push_back(SolverBody{c, Vector2{0.0f, 0.0f}});
+            }
+            return c->solverBody_;
+        };
+        const auto bodyA = body(a);
+        const auto bodyB = body(b);
+        if (bodyA == noSolverBody_ && bodyB == noSolverBody_)
+            return;
+
+        // A swept collider that stops inside the slop would start its next sweep overlapping and pass through.
+        const bool exact = manifold.toi < 1.0f;
+        solverContacts_.push_back(SolverContact{bodyA, bodyB, manifold.normal, manifold.depth, exact});
+    }
+
+    void CollisionSystem::solveContacts_() {
+        const auto movable = [this](const std::uint32_t body) {
+            return body != noSolverBody_ && solverBodies_[body].collider != nullptr;
+        };
+        const auto correction = [&](const std::uint32_t body) {
+            return movable(body) ? solverBodies_[body].correction : Vector2{0.0f, 0.0f};
+        };
+
+        // Gauss-Seidel over positions: every contact sees the corrections of the ones before it. The penetration
+        // is estimated from the accumulated corrections along the contact normal instead of being measured again.
+        for (int iteration = 0; iteration < solverConfig_.iterations; ++iteration) {
+            for (const auto& contact : solverContacts_) {
+                const bool moveA = movable(contact.a);
+                const bool moveB = movable(contact.b);
+                if (!moveA && !moveB)
+                    continue;
+
+                const auto relative = Vector2Subtract(correction(contact.a), correction(contact.b));
+                const float depth = contact.depth + Vector2DotProduct(relative, contact.normal);
+                const float error =
+                    contact.exact ? depth : (depth - solverConfig_.slop) * solverConfig_.baumgarte;
+                if (error <= 0.0f)
+                    continue;
+
+                const auto push = Vector2Scale(contact.normal, error / static_cast<float>(moveA + moveB));
+                if (moveA)
+                    solverBodies_[contact.a].correction = Vector2Subtract(solverBodies_[contact.a].correction, push);
+                if (moveB)
+                    solverBodies_[contact.b].correction = Vector2Add(solverBodies_[contact.b].correction, push);
+            }
+        }
+
+        // Transforms are only written once the contacts agree.
+        for (const auto& [collider, total] : solverBodies_) {
+            if (!collider)
+                continue;
+            collider->solverBody_ = noSolverBody_;
+            if (total.x != 0.0f || total.y != 0.0f)
+                collider->resolve(total);
+        }
+        solverBodies_.clear();
+    }
+
+    std::uint32_t CollisionSystem::bodyState_(const Collider& c) {
+        auto* body = c.body_;
+        if (!body || c.isStatic())
+            return noBodyState_;
+        if (body->state_ == RigidBody::noState_) {
+            body->state_ = static_cast<std::uint32_t>(bodyStates_.size());
+            bodyStates_.push_back(BodyState{body, Vector2{0.0f, 0.0f}, Vector2{0.0f, 0.0f}, 0.0f, false});
+        }
+        return body->state_;
+    }
+
+    void CollisionSystem::addBodyContact_(Collider* a, Collider* b, const CollisionManifold& manifold,
+                                          const std::uint32_t record) {
+        // Triggers and sensors never push bodies.
+        const auto solid = [](const Collider& c) {
+            return !c.isTrigger() && (c.type() == ColliderType::Solid || c.type() == ColliderType::Kinematic);
+        };
+        if (!solid(*a) || !solid(*b))
+            return;
+        const ContactKey key{a->order_, b->order_};
+        const auto cached = contacts_.find(key);
+        if (cached == contacts_.end())
+            return; // a callback destroyed one of the two
+
+        // A body resting against a collider without a dynamic body is woken once that collider moves; contacts
+        // between dynamic bodies wake through their islands instead.
+        const bool movedA = record == noRecord_ || records_[record].revisionA != a->revision_;
+        const bool movedB = record == noRecord_ || records_[record].revisionB != b->revision_;
+        const auto dynamic = [](const Collider& c) { return c.body_ && !c.body_->isKinematic() && !c.isStatic(); };
+        if (a->body_ && movedB && !dynamic(*b))
+            a->body_->wake();
+        if (b->body_ && movedA && !dynamic(*a))
+            b->body_->wake();
+
+        const auto stateA = bodyState_(*a);
+        const auto stateB = bodyState_(*b);
+        if (stateA == noBodyState_ && stateB == noBodyState_)
+            return;
+
+        // A side without a body takes the other side's surface.
+        const auto* bodyA = a->body_ ? a->body_ : b->body_;
+        const auto* bodyB = b->body_ ? b->body_ : a->body_;
+        bodyContacts_.push_back(BodyContact{key, stateA, stateB, manifold.normal, manifold.depth,
+                                            std::sqrt(bodyA->friction_ * bodyB->friction_),
+                                            std::max(bodyA->restitution_, bodyB->restitution_), 0.0f, 0.0f,
+                                            cached->second.impulse.x, cached->second.impulse.y,
+                                            manifold.toi < 1.0f});
+    }
+
+    void CollisionSystem::stepBodies_(const float dt) {
+        const auto& config = physicsConfig_;
+        physicsTime_ += dt;
+        auto substeps = static_cast<int>(physicsTime_ / config.substep);
+        if (substeps > config.maxSubsteps) {
+            substeps = config.maxSubsteps;
+            physicsTime_ = 0.0f;
+        }
+        else {
+            physicsTime_ -= static_cast<float>(substeps) * config.substep;
+        }
+
+        if (substeps > 0) {
+            // Every awake body moves; sleeping ones only take part when a contact may wake them.
+            for (auto* body : bodies_) {
+                if (!body->transform_)
+                    body->transform_ = body->entity().get<Transform>();
+                if (body->transform_ && body->transform_->version() != body->version_) {
+                    body->version_ = body->transform_->version();
+                    body->wake(); // moved by the game
+                }
+                if (body->sleeping_ || (body->collider_ && body->collider_->isStatic()))
+                    continue;
+                if (body->state_ == RigidBody::noState_) {
+                    body->state_ = static_cast<std::uint32_t>(bodyStates_.size());
+                    bodyStates_.push_back(BodyState{body, Vector2{0.0f, 0.0f}, Vector2{0.0f, 0.0f}, 0.0f, false});
+                }
+            }
+            for (auto& state : bodyStates_) {
+                auto* body = state.body;
+                if (!body)
+                    continue;
+                state.velocity = body->velocity_;
+                state.inverseMass = body->isKinematic() ? 0.0f : 1.0f / body->mass_;
+                state.awake = !body->sleeping_;
+            }
+
+            // Islands: dynamic bodies joined by their contacts. Kinematic bodies and colliders without a body
+            // do not join islands, or a whole level would become one.
+            islands_.resize(bodyStates_.size());
+            for (std::uint32_t i = 0; i < islands_.size(); ++i) {
+                islands_[i] = i;
+            }
+            const auto dynamic = [this](const std::uint32_t state) {
+                return state != noBodyState_ && bodyStates_[state].body && bodyStates_[state].inverseMass > 0.0f;
+            };
+            for (const auto& contact : bodyContacts_) {
+                if (dynamic(contact.a) && dynamic(contact.b))
+                    islands_[islandRoot(islands_, contact.a)] = islandRoot(islands_, contact.b);
+            }
+            // An island wakes as a whole as soon as one of its bodies is awake.
+            islandSleep_.assign(bodyStates_.size(), 0.0f);
+            for (std::uint32_t i = 0; i < bodyStates_.size(); ++i) {
+                if (bodyStates_[i].awake)
+                    islandSleep_[islandRoot(islands_, i)] = 1.0f;
+            }
+            for (std::uint32_t i = 0; i < bodyStates_.size(); ++i) {
+                auto& state = bodyStates_[i];
+                if (state.body && !state.awake && islandSleep_[islandRoot(islands_, i)] > 0.0f) {
+                    state.body->wake();
+                    state.awake = true;
+                }
+            }
+
+            // Contacts without an awake dynamic body keep their cached impulses for when they wake.
+            const auto active = [&](const std::uint32_t state) { return dynamic(state) && bodyStates_[state].awake; };
+            std::erase_if(bodyContacts_, [&](const BodyContact& c) { return !active(c.a) && !active(c.b); });
+
+            const auto velocity = [this](const std::uint32_t state) {
+                return state != noBodyState_ ? bodyStates_[state].velocity : Vector2{0.0f, 0.0f};
+            };
+            const auto inverseMass = [this](const std::uint32_t state) {
+                return state != noBodyState_ ? bodyStates_[state].inverseMass : 0.0f;
+            };
+            for (auto& contact : bodyContacts_) {
+                contact.mass = 1.0f / (inverseMass(contact.a) + inverseMass(contact.b));
+                contact.approach =
+                    Vector2DotProduct(Vector2Subtract(velocity(contact.b), velocity(contact.a)), contact.normal);
+            }
+
+            const auto apply = [this](const BodyContact& contact, const Vector2 impulse) {
+                if (contact.a != noBodyState_) {
+                    auto& a = bodyStates_[contact.a];
+                    a.velocity = Vector2Subtract(a.velocity, Vector2Scale(impulse, a.inverseMass));
+                }
+                if (contact.b != noBodyState_) {
+                    auto& b = bodyStates_[contact.b];
+                    b.velocity = Vector2Add(b.velocity, Vector2Scale(impulse, b.inverseMass));
+                }
+            };
+
+            const float h = config.substep;
+            const float inverseH = 1.0f / h;
+            // Sequential impulses. The penetration is estimated from how far the bodies moved along the normal
+            // since the contact was found, so the substeps need no new narrow phase. Without bias, the pass only
+            // removes approaching velocity: it takes back the push-out speed of the biased passes, which would
+            // otherwise make resting bodies hop.
+            const auto solve = [&](const bool bias) {
+                for (auto& contact : bodyContacts_) {
+                    const auto tangent = Vector2{-contact.normal.y, contact.normal.x};
+                    auto relative = Vector2Subtract(velocity(contact.b), velocity(contact.a));
+
+                    // Friction first, bounded by the normal impulse of the previous pass
+                    const float limit = contact.friction * contact.normalImpulse;
+                    const float tangentImpulse = std::clamp(
+                        contact.tangentImpulse - contact.mass * Vector2DotProduct(relative, tangent), -limit, limit);
+                    apply(contact, Vector2Scale(tangent, tangentImpulse - contact.tangentImpulse));
+                    contact.tangentImpulse = tangentImpulse;
+
+                    const auto moved = Vector2Subtract(
+                        contact.b != noBodyState_ ? bodyStates_[contact.b].displacement : Vector2{0.0f, 0.0f},
+                        contact.a != noBodyState_ ? bodyStates_[contact.a].displacement : Vector2{0.0f, 0.0f});
+                    const float depth = contact.depth - Vector2DotProduct(moved, contact.normal);
+                    float target = 0.0f;
+                    if (depth < 0.0f)
+                        target = depth * inverseH; // still apart: may close the gap, but no further
+                    else if (bias)
+                        target = std::min(config.baumgarte * inverseH *
+                                              std::max(depth - (contact.exact ? 0.0f : config.slop), 0.0f),
+                                          config.maxPushSpeed);
+
+                    relative = Vector2Subtract(velocity(contact.b), velocity(contact.a));
+                    const float normalImpulse = std::max(
+                        contact.normalImpulse - contact.mass * (Vector2DotProduct(relative, contact.normal) - target),
+                        0.0f);
+                    apply(contact, Vector2Scale(contact.normal, normalImpulse - contact.normalImpulse));
+                    contact.normalImpulse = normalImpulse;
+                }
+            };
+
+            for (int step = 0; step < substeps; ++step) {
+                for (auto& state : bodyStates_) {
+                    if (!state.body || !state.awake || state.inverseMass == 0.0f)
+                        continue;
+                    const auto* body = state.body;
+                    const auto acceleration = Vector2Add(Vector2Scale(config.gravity, body->gravityScale_),
+                                                         Vector2Scale(body->force_, state.inverseMass));
+                    state.velocity = Vector2Scale(Vector2Add(state.velocity, Vector2Scale(acceleration, h)),
+                                                  1.0f / (1.0f + h * body->damping_));
+                }
+                for (const auto& contact : bodyContacts_) {
+                    apply(contact, Vector2Add(Vector2Scale(contact.normal, contact.normalImpulse),
+                                              Vector2Scale(Vector2{-contact.normal.y, contact.normal.x},
+                                                           contact.tangentImpulse)));
+                }
+                for (int iteration = 0; iteration < config.iterations; ++iteration) {
+                    solve(true);
+                }
+                for (auto& state : bodyStates_) {
+                    if (state.awake)
+                        state.displacement = Vector2Add(state.displacement, Vector2Scale(state.velocity, h));
+                }
+                solve(false);
+            }
+
+            // Bounces use the approach speed from before the update, which the substeps have already cancelled.
+            for (auto& contact : bodyContacts_) {
+                if (contact.restitution == 0.0f || contact.approach > -config.restitutionThreshold ||
+                    contact.normalImpulse == 0.0f)
+                    continue;
+                const auto relative = Vector2Subtract(velocity(contact.b), velocity(contact.a));
+                const float normalImpulse = std::max(
+                    contact.normalImpulse - contact.mass * (Vector2DotProduct(relative, contact.normal) +
+                                                            contact.restitution * contact.approach),
+                    0.0f);
+                apply(contact, Vector2Scale(contact.normal, normalImpulse - contact.normalImpulse));
+                contact.normalImpulse = normalImpulse;
+            }
+
+            for (const auto& contact : bodyContacts_) {
+                if (const auto it = contacts_.find(contact.key); it != contacts_.end())
+                    it->second.impulse = Vector2{contact.normalImpulse, contact.tangentImpulse};
+            }
+
+            // Transforms are only written once all substeps ran.
+            for (auto& state : bodyStates_) {
+                auto* body = state.body;
+                if (!body || !state.awake)
+                    continue;
+                body->velocity_ = state.velocity;
+                body->force_ = Vector2{0.0f, 0.0f};
+                if (auto* t = body->transform_; t && (state.displacement.x != 0.0f || state.displacement.y != 0.0f)) {
+                    t->position = Vector2Add(t->position, state.displacement);
+                    body->version_ = t->version();
+                }
+            }
+            sleepIslands_(static_cast<float>(substeps) * h);
+        }
+
+        stats_.bodyContacts = bodyContacts_.size();
+        stats_.substeps = static_cast<std::size_t>(substeps);
+        for (const auto& state : bodyStates_) {
+            if (state.body) {
+                state.body->state_ = RigidBody::noState_;
+                stats_.bodies += state.awake;
+            }
+        }
+        bodyStates_.clear();
+        bodyContacts_.clear();
+    }
+
+    void CollisionSystem::sleepIslands_(const float elapsed) {
+        // An island sleeps once every body in it has been slow for long enough; until then none of them does.
+        islandSleep_.assign(bodyStates_.size(), FLT_MAX);
+        for (std::uint32_t i = 0; i < bodyStates_.size(); ++i) {
+            auto* body = bodyStates_[i].body;
+            if (!body || !bodyStates_[i].awake)
+                continue;
+            const float speed = Vector2Length(body->velocity_);
+            body->sleepTime_ = speed < physicsConfig_.sleepSpeed ? body->sleepTime_ + elapsed : 0.0f;
+            auto& island = islandSleep_[islandRoot(islands_, i)];
+            island = std::min(island, body->sleepTime_);
+        }
+        for (std::uint32_t i = 0; i < bodyStates_.size(); ++i) {
+            auto& state = bodyStates_[i];
+            if (!state.body || !state.awake || islandSleep_[islandRoot(islands_, i)] < physicsConfig_.timeToSleep)
+                continue;
+            state.body->sleeping_ = true;
+            state.body->velocity_ = Vector2{0.0f, 0.0f};
+            state.awake = false;
+        }
     }
 
 }
@@ -1,30 +1,286 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+#include "broad_phase.hpp"
+#include "collider_types.hpp"
 #include "debug.hpp"
+#include "static_bvh.hpp"
 
 namespace rlge {
     class Collider;
-    struct CollisionManifold;
+    class EventBus;
+    class RigidBody;
+    class Transform;
+    class WorkerPool;
 
     class CollisionSystem : public HasDebugOverlay {
     public:
+        CollisionSystem();
+        ~CollisionSystem() override;
+
         void registerCollider(Collider* c);
         void unregisterCollider(Collider* c);
+        void registerBody(RigidBody* body);
+        void unregisterBody(RigidBody* body);
         void update(float dt);
+        // Bus that receives a CollisionContactsEvent after every update with contact changes. May be null.
+        void setEventBus(EventBus* events);
+        [[nodiscard]] std::size_t contactCount() const;
+        // Switches the broad-phase backend. Proxies are rebuilt on the next update; do not call from a collision
+        // callback.
+        void setBroadPhase(BroadPhaseType type);
+        [[nodiscard]] BroadPhaseType broadPhase() const;
+        void setBroadPhaseConfig(const BroadPhaseConfig& config);
+        [[nodiscard]] const BroadPhaseConfig& broadPhaseConfig() const;
+        // Edge length of the spatial hash cells, in world units. Roughly the size of a typical collider works best.
+        void setCellSize(float cellSize);
+        [[nodiscard]] float cellSize() const;
+        // Threads that help with the SAT tests of polygon and OBB pairs. Results are merged in pair order, so
+        // callbacks and resolution happen on the calling thread in the same sequence regardless of the count.
+        // 0 keeps the whole narrow phase on the calling thread.
+        void setWorkerThreads(unsigned count);
+        [[nodiscard]] unsigned workerThreads() const;
+        void setSolverConfig(const SolverConfig& config);
+        [[nodiscard]] const SolverConfig& solverConfig() const;
+        void setPhysicsConfig(const PhysicsConfig& config);
+        [[nodiscard]] const PhysicsConfig& physicsConfig() const;
+        // Counters and stage timings of the last update; the debug overlay plots their history.
+        [[nodiscard]] const CollisionStats& stats() const;
+        // Colliders on layers that do not interact are never paired, not even by the broad phase: dynamic
+        // colliders are kept in one broad phase per layer, and only buckets whose layers interact are paired up.
+        // Symmetric; every bit of a is paired with every bit of b. All layers interact by default, and the
+        // collider masks still apply on top.
+        void setLayersInteract(ColliderLayerMask a, ColliderLayerMask b, bool interact);
+        [[nodiscard]] bool layersInteract(ColliderLayerMask a, ColliderLayerMask b) const;
+        // Rebuilds the static partition on the next update, e.g. after a static collider was moved by hand.
+        void invalidateStatic();
+
+        // Spatial queries. Candidates come from the broad phase as it stood after the last update and are then
+        // tested against their exact shapes, so colliders created since that update are not found yet. Results
+        // are written in registration order to the caller's buffer: at most out.size() of them, and the number
+        // written is returned.
+        std::size_t queryPoint(Vector2 point, std::span<Collider*> out, const QueryFilter& filter = {});
+        std::size_t queryCircle(Vector2 center, float radius, std::span<Collider*> out,
+                                const QueryFilter& filter = {});
+        std::size_t queryRect(const Rectangle& rect, std::span<Collider*> out, const QueryFilter& filter = {});
+        // First collider along the segment from -> to. A collider containing `from` is hit at fraction 0.
+        bool raycast(Vector2 from, Vector2 to, CastHit& hit, const QueryFilter& filter = {});
+        // Every collider along the segment, closest first. When out is too small, the closest hits are kept.
+        std::size_t raycastAll(Vector2 from, Vector2 to, std::span<CastHit> out, const QueryFilter& filter = {});
+        // First collider hit by a circle moving by `motion`.
+        bool circleCast(Vector2 center, float radius, Vector2 motion, CastHit& hit, const QueryFilter& filter = {});
+        // First collider hit by `shape` moving by `motion`; the shape itself is always ignored.
+        bool shapeCast(const Collider& shape, Vector2 motion, CastHit& hit, QueryFilter filter = {});
         void setDebug(bool debug);
         [[nodiscard]] bool debug() const;
         void debugOverlay() override;
 
     private:
-        void compact_();
+        friend class Collider;
+
+        void staticChanged_(Collider* c);
+        void rebuildStatic_();
         void flushPendingRemovals_();
-        void resolve_(Collider* a, Collider* b, const CollisionManifold& manifold);
+        [[nodiscard]] std::uint32_t partners_(ColliderLayerMask layer) const;
+        void addProxy_(Collider* c, const Rectangle& bounds);
+        void removeProxy_(Collider* c);
+        void collectPairs_();
+        // Pairs are visited by the registration order of their first collider, then of their second.
+        [[nodiscard]] static bool pairBefore_(const ColliderPair& l, const ColliderPair& r);
+        // Collects the pairs still to be visited again for every collider a callback moved.
+        void recollectMoved_(const ColliderPair& current);
+        void recollect_(Collider& c, const ColliderPair& current);
+        void matchRecords_();
+        [[nodiscard]] const CollisionManifold* sleeping_(std::size_t pair, const Collider& a, const Collider& b) const;
+        void prepareNarrowPhase_();
+        static void endSweeps_(const std::vector<Collider*>& colliders);
+        [[nodiscard]] static Rectangle sweptBounds_(const Collider& c);
+        [[nodiscard]] CollisionManifold sweptTest_(const Collider& a, const Collider& b);
+        [[nodiscard]] static bool movable_(const Collider& c);
+        [[nodiscard]] static bool overlapOnly_(const Collider& a, const Collider& b);
+        [[nodiscard]] static CollisionManifold narrowTest_(const Collider& a, ColliderShape shapeA, const Collider& b,
+                                                           ColliderShape shapeB);
+        // Per-circle hits of `batch` when it is a CircleBatchCollider touching `other`.
+        static void reportBatchHits_(const Collider& batch, const Collider& other);
+        void addSolverContact_(Collider* a, Collider* b, const CollisionManifold& manifold);
+        void solveContacts_();
+        // Contacts of rigid bodies go to the impulse solver instead of the position solver.
+        void addBodyContact_(Collider* a, Collider* b, const CollisionManifold& manifold, std::uint32_t record);
+        [[nodiscard]] std::uint32_t bodyState_(const Collider& c);
+        void stepBodies_(float dt);
+        void sleepIslands_(float elapsed);
+        void trackContact_(Collider* a, Collider* b, const CollisionManifold& manifold);
+        void endStaleContacts_();
+        void dropContacts_(Collider* c);
+        void publishContacts_();
+        template <typename Fn>
+        void forEachCandidate_(const Aabb& box, const QueryFilter& filter, Fn&& fn);
+        bool castFirst_(const ConvexSupport& shape, const Aabb& box, Vector2 motion, CastHit& hit,
+                        const QueryFilter& filter);
 
     private:
         bool updating_ = false;
+        // Dense; every collider knows its slot, so both registering and unregistering are O(1). Colliders
+        // unregistered during an update leave a null slot behind until the update ends.
         std::vector<Collider*> colliders_;
-        std::vector<Collider*> pendingRemovals_;
+        std::vector<std::uint32_t> pendingRemovals_; // slots to remove once the update ends
+        BroadPhaseType broadPhaseType_ = BroadPhaseType::SpatialHash;
+        BroadPhaseConfig broadPhaseConfig_;
+
+        // Dynamic colliders sharing a layer value, with their own broad phase.
+        struct LayerBucket {
+            ColliderLayerMask layer;
+            std::unique_ptr<BroadPhase> broadPhase;
+            std::vector<Collider*> colliders; // every collider with a proxy in broadPhase
+            std::uint32_t partners = 0; // layer bits this bucket interacts with, as of the last update
+        };
+
+        std::vector<LayerBucket> buckets_;
+        std::array<std::uint32_t, colliderLayerCount> layerMatrix_; // bit j of entry i: layers i and j interact
+        std::vector<ColliderPair> pairs_;
+        // Pairs a callback moved a collider into during the pair loop, in visiting order; merged into pairs_ as
+        // the loop goes, so the pairs visited match those of an exhaustive loop.
+        std::vector<ColliderPair> latePairs_;
+        std::vector<Collider*> movedColliders_; // moved during this update's pair loop; their proxies are stale
+
+        // Where a dynamic collider's transform stood when its candidates were last collected. Transforms have
+        // no change notification, so these are polled after callbacks run.
+        struct Placement {
+            Collider* collider;
+            const Transform* transform;
+            Vector2 position;
+            float rotation;
+            Vector2 scale;
+        };
+
+        std::vector<Placement> placements_;
+        StaticBvh static_;
+        std::vector<Collider*> staticColliders_;
+        bool staticDirty_ = false;
+
+        struct ContactKey {
+            std::uint64_t a; // registration sequence of the first collider
+            std::uint64_t b;
+            bool operator==(const ContactKey&) const = default;
+        };
+
+        struct ContactKeyHash {
+            std::size_t operator()(const ContactKey& k) const {
+                return std::hash<std::uint64_t>{}(k.a * 0x9E3779B97F4A7C15ull ^ k.b);
+            }
+        };
+
+        struct Contact {
+            Collider* a;
+            Collider* b;
+            CollisionManifold manifold;
+            std::uint64_t frame; // last update the pair was touching
+            Vector2 impulse{0.0f, 0.0f}; // normal and tangent impulse of the body solver's last substep
+        };
+
+        // Narrow-phase tests run ahead of the pair loop; a result is only used if neither transform changed since.
+        struct NarrowTask {
+            std::uint32_t pair;
+            std::uint32_t versionA;
+            std::uint32_t versionB;
+        };
+
+        static constexpr std::size_t minParallelTasks_ = 64;
+
+        // Narrow-phase result of a pair, reused as long as neither collider's geometry was rebuilt since.
+        struct PairRecord {
+            std::uint64_t a; // registration sequences, like ContactKey
+            std::uint64_t b;
+            std::uint32_t revisionA;
+            std::uint32_t revisionB;
+            CollisionManifold manifold;
+        };
+
+        static constexpr std::uint32_t noRecord_ = ~0u;
+
+        std::vector<PairRecord> records_; // previous update, in pair order
+        std::vector<PairRecord> nextRecords_;
+        std::vector<std::uint32_t> pairRecords_; // per entry of pairs_, index into records_ or noRecord_
+
+        static constexpr std::uint32_t noSolverBody_ = ~0u;
+
+        struct SolverBody {
+            Collider* collider; // null once destroyed by a callback
+            Vector2 correction;
+        };
+
+        struct SolverContact {
+            std::uint32_t a; // solver bodies, or noSolverBody_ for a side that is never moved
+            std::uint32_t b;
+            Vector2 normal; // from a to b
+            float depth;
+            bool exact; // continuous contacts are corrected in full, without slop
+        };
+
+        SolverConfig solverConfig_;
+        std::vector<SolverBody> solverBodies_;
+        std::vector<SolverContact> solverContacts_; // kept until the next update for the debug overlay
+
+        static constexpr std::uint32_t noBodyState_ = ~0u;
+
+        struct BodyState {
+            RigidBody* body; // null once destroyed by a callback
+            Vector2 velocity;
+            Vector2 displacement; // since the update began
+            float inverseMass; // 0 for kinematic bodies
+            bool awake;
+        };
+
+        struct BodyContact {
+            ContactKey key; // entry of contacts_ that keeps the impulses for the next update
+            std::uint32_t a; // body states, or noBodyState_ for a side without a body
+            std::uint32_t b;
+            Vector2 normal; // from a to b
+            float depth; // at the start of the update
+            float friction;
+            float restitution;
+            float mass; // effective mass; bodies only translate, so the same along normal and tangent
+            float approach; // normal velocity before the update, negative when closing
+            float normalImpulse; // accumulated over the substep, warm-started from the contact cache
+            float tangentImpulse;
+            bool exact; // continuous contacts are corrected in full, without slop
+        };
+
+        PhysicsConfig physicsConfig_;
+        float physicsTime_ = 0.0f; // simulated time owed to the bodies, less than one substep
+        std::vector<RigidBody*> bodies_;
+        std::vector<BodyState> bodyStates_;
+        std::vector<BodyContact> bodyContacts_;
+        std::vector<std::uint32_t> islands_; // union-find parents over bodyStates_
+        std::vector<float> islandSleep_; // per island root: whether any member is awake, then its shortest rest
+
+        unsigned workerThreads_;
+        std::unique_ptr<WorkerPool> workers_;
+        std::vector<NarrowTask> narrowTasks_;
+        std::vector<std::vector<CollisionManifold>> narrowBuffers_; // one per pool slot
+        std::vector<CollisionManifold> narrowManifolds_; // merged, indexed like narrowTasks_
+        std::vector<Collider*> queryCandidates_;
+        std::vector<Vector2> sweptCore_; // sweptTest_ scratch: the moving shape where the frame began
+
+        std::unordered_map<ContactKey, Contact, ContactKeyHash> contacts_;
+        std::uint64_t frame_ = 0;
+        std::vector<ContactEvent> entered_;
+        std::vector<ContactEvent> stayed_;
+        std::vector<ContactEvent> exited_;
+        EventBus* events_ = nullptr;
+        std::uint64_t nextOrder_ = 0;
         bool debug_ = false;
+
+        static constexpr std::size_t statsHistory_ = 120;
+
+        CollisionStats stats_;
+        // Stage timings of the last statsHistory_ updates: broad phase, narrow phase, solver, total.
+        std::array<std::array<float, statsHistory_>, 4> timingHistory_{};
+        std::size_t historyOffset_ = 0;
     };
 }
@@ -0,0 +1,360 @@
+#include "dynamic_aabb_tree.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace rlge {
+
+    DynamicAabbTree::DynamicAabbTree(const BroadPhaseConfig& config) :
+        margin_(config.treeMargin), displacementMultiplier_(config.treeDisplacementMultiplier) {}
+
+    void DynamicAabbTree::configure(const BroadPhaseConfig& config) {
+        // Takes effect as proxies get reinserted.
+        margin_ = config.treeMargin;
+        displacementMultiplier_ = config.treeDisplacementMultiplier;
+    }
+
+    ProxyId DynamicAabbTree::allocateNode_() {
+        if (freeList_ == NullProxy) {
+            nodes_.emplace_back();
+            nodes_.back().height = 0;
+            return static_cast<ProxyId>(nodes_.size() - 1);
+        }
+
+        const ProxyId id = freeList_;
+        freeList_ = nodes_[id].parent;
+        const bool touched = nodes_[id].touched;
+        nodes_[id] = Node{};
+        nodes_[id].height = 0;
+        nodes_[id].touched = touched;
+        return id;
+    }
+
+    void DynamicAabbTree::freeNode_(const ProxyId node) {
+        auto& n = nodes_[node];
+        n.collider = nullptr;
+        n.child1 = NullProxy;
+        n.child2 = NullProxy;
+        n.height = -1;
+        n.parent = freeList_;
+        freeList_ = node;
+    }
+
+    Aabb DynamicAabbTree::fatten_(const Aabb& tight, const float dx, const float dy) const {
+        Aabb fat{tight.minX - margin_, tight.minY - margin_, tight.maxX + margin_, tight.maxY + margin_};
+
+        // Predict where the collider is heading so a steadily moving proxy is not reinserted every frame.
+        const float px = dx * displacementMultiplier_;
+        const float py = dy * displacementMultiplier_;
+        if (px < 0.0f)
+            fat.minX += px;
+        else
+            fat.maxX += px;
+        if (py < 0.0f)
+            fat.minY += py;
+        else
+            fat.maxY += py;
+        return fat;
+    }
+
+    void DynamicAabbTree::touch_(const ProxyId proxy) {
+        if (nodes_[proxy].touched)
+            return;
+        nodes_[proxy].touched = true;
+        moved_.push_back(proxy);
+    }
+
+    ProxyId DynamicAabbTree::createProxy(Collider* collider, const Rectangle& bounds) {
+        const ProxyId id = allocateNode_();
+        auto& node = nodes_[id];
+        node.tight = Aabb::fromRect(bounds);
+        node.box = fatten_(node.tight, 0.0f, 0.0f);
+        node.collider = collider;
+
+        insertLeaf_(id);
+        touch_(id);
+        return id;
+    }
+
+    void DynamicAabbTree::destroyProxy(const ProxyId proxy) {
+        removeLeaf_(proxy);
+        // Flag the id so pairs cached against it are dropped, even if the node is reused before the next query.
+        touch_(proxy);
+        freeNode_(proxy);
+    }
+
+    void DynamicAabbTree::moveProxy(const ProxyId proxy, const Rectangle& bounds) {
+        const Aabb tight = Aabb::fromRect(bounds);
+        const Aabb previous = nodes_[proxy].tight;
+        nodes_[proxy].tight = tight;
+
+        const float dx = ((tight.minX + tight.maxX) - (previous.minX + previous.maxX)) * 0.5f;
+        const float dy = ((tight.minY + tight.maxY) - (previous.minY + previous.maxY)) * 0.5f;
+        const Aabb fat = fatten_(tight, dx, dy);
+
+        if (nodes_[proxy].box.contains(tight)) {
+            // Still inside the fat box. Only reinsert when the stored box has grown far too large for the
+            // collider, e.g. after a fast movement stopped, so it does not keep producing false pairs.
+            const float huge = 4.0f * margin_;
+            const Aabb limit{fat.minX - huge, fat.minY - huge, fat.maxX + huge, fat.maxY + huge};
+            if (limit.contains(nodes_[proxy].box))
+                return;
+        }
+
+        removeLeaf_(proxy);
+        nodes_[proxy].box = fat;
+        insertLeaf_(proxy);
+        touch_(proxy);
+    }
+
+    void DynamicAabbTree::collectPairs(std::vector<ColliderPair>& out) {
+        // Pairs between untouched proxies are still valid: neither fat box changed since they were found.
+        std::erase_if(pairs_, [this](const ProxyPair& p) {
+            return nodes_[p.a].touched || nodes_[p.b].touched;
+        });
+
+        for (const ProxyId id : moved_) {
+            const auto& node = nodes_[id];
+            if (node.height != 0 || !node.collider)
+                // Destroyed, or the id now belongs to an internal node
+                continue;
+
+            query(node.box, [this, id](const ProxyId other) {
+                if (other == id)
+                    return true;
+                if (nodes_[other].touched && other < id)
+                    // Both proxies moved; the lower id reports the pair
+                    return true;
+                pairs_.push_back(ProxyPair{std::min(id, other), std::max(id, other)});
+                return true;
+            });
+        }
+
+        for (const ProxyId id : moved_) {
+            nodes_[id].touched = false;
+        }
+        moved_.clear();
+
+        out.reserve(out.size() + pairs_.size());
+        for (const auto& [a, b] : pairs_) {
+            out.push_back(ColliderPair{nodes_[a].collider, nodes_[b].collider});
+        }
+    }
+
+    void DynamicAabbTree::query(const Aabb& box, std::vector<Collider*>& out) const {
+        query(box, [this, &box, &out](const ProxyId id) {
+            // The fat box only narrows the search; report the collider if its real bounds overlap.
+            if (nodes_[id].tight.overlaps(box))
+                out.push_back(nodes_[id].collider);
+            return true;
+        });
+    }
+
+    void DynamicAabbTree::refit_(ProxyId node) {
+        while (node != NullProxy) {
+            node = balance_(node);
+
+            auto& n = nodes_[node];
+            const auto& c1 = nodes_[n.child1];
+            const auto& c2 = nodes_[n.child2];
+            n.height = 1 + std::max(c1.height, c2.height);
+            n.box = Aabb::merge(c1.box, c2.box);
+
+            node = n.parent;
+        }
+    }
+
+    void DynamicAabbTree::insertLeaf_(const ProxyId leaf) {
+        if (root_ == NullProxy) {
+            root_ = leaf;
+            nodes_[root_].parent = NullProxy;
+            return;
+        }
+
+        // Walk down picking the child with the lowest surface area heuristic cost.
+        const Aabb leafBox = nodes_[leaf].box;
+        ProxyId index = root_;
+        while (!nodes_[index].isLeaf()) {
+            const auto& node = nodes_[index];
+            const ProxyId child1 = node.child1;
+            const ProxyId child2 = node.child2;
+
+            const float area = node.box.perimeter();
+            const float combinedArea = Aabb::merge(node.box, leafBox).perimeter();
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            const auto descendCost = [&](const ProxyId child) {
+                const auto& c = nodes_[child];
+                const float merged = Aabb::merge(leafBox, c.box).perimeter();
+                return (c.isLeaf() ? merged : merged - c.box.perimeter()) + inheritanceCost;
+            };
+            const float cost1 = descendCost(child1);
+            const float cost2 = descendCost(child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        const ProxyId sibling = index;
+        const ProxyId oldParent = nodes_[sibling].parent;
+        const ProxyId newParent = allocateNode_();
+
+        auto& parent = nodes_[newParent];
+        parent.parent = oldParent;
+        parent.box = Aabb::merge(leafBox, nodes_[sibling].box);
+        parent.height = nodes_[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        nodes_[sibling].parent = newParent;
+        nodes_[leaf].parent = newParent;
+
+        if (oldParent != NullProxy) {
+            auto& op = nodes_[oldParent];
+            if (op.child1 == sibling)
+                op.child1 = newParent;
+            else
+                op.child2 = newParent;
+        }
+        else {
+            root_ = newParent;
+        }
+
+        refit_(nodes_[leaf].parent);
+    }
+
+    void DynamicAabbTree::removeLeaf_(const ProxyId leaf) {
+        if (leaf == root_) {
+            root_ = NullProxy;
+            return;
+        }
+
+        const ProxyId parent = nodes_[leaf].parent;
+        const ProxyId grandParent = nodes_[parent].parent;
+        const ProxyId sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+        if (grandParent != NullProxy) {
+            auto& gp = nodes_[grandParent];
+            if (gp.child1 == parent)
+                gp.child1 = sibling;
+            else
+                gp.child2 = sibling;
+            nodes_[sibling].parent = grandParent;
+            freeNode_(parent);
+            refit_(grandParent);
+        }
+        else {
+            root_ = sibling;
+            nodes_[sibling].parent = NullProxy;
+            freeNode_(parent);
+        }
+    }
+
+    // Performs a left or right rotation if node a is imbalanced. Returns the new root of the subtree.
+    ProxyId DynamicAabbTree::balance_(const ProxyId a) {
+        auto& A = nodes_[a];
+        if (A.isLeaf() || A.height < 2)
+            return a;
+
+        const ProxyId b = A.child1;
+        const ProxyId c = A.child2;
+        auto& B = nodes_[b];
+        auto& C = nodes_[c];
+
+        const std::int32_t balance = C.height - B.height;
+
+        // Rotate C up
+        if (balance > 1) {
+            const ProxyId f = C.child1;
+            const ProxyId g = C.child2;
+            auto& F = nodes_[f];
+            auto& G = nodes_[g];
+
+            C.child1 = a;
+            C.parent = A.parent;
+            A.parent = c;
+
+            if (C.parent != NullProxy) {
+                auto& cp = nodes_[C.parent];
+                if (cp.child1 == a)
+                    cp.child1 = c;
+                else
+                    cp.child2 = c;
+            }
+            else {
+                root_ = c;
+            }
+
+            if (F.height > G.height) {
+                C.child2 = f;
+                A.child2 = g;
+                G.parent = a;
+                A.box = Aabb::merge(B.box, G.box);
+                C.box = Aabb::merge(A.box, F.box);
+                A.height = 1 + std::max(B.height, G.height);
+                C.height = 1 + std::max(A.height, F.height);
+            }
+            else {
+                C.child2 = g;
+                A.child2 = f;
+                F.parent = a;
+                A.box = Aabb::merge(B.box, F.box);
+                C.box = Aabb::merge(A.box, G.box);
+                A.height = 1 + std::max(B.height, F.height);
+                C.height = 1 + std::max(A.height, G.height);
+            }
+            return c;
+        }
+
+        // Rotate B up
+        if (balance < -1) {
+            const ProxyId d = B.child1;
+            const ProxyId e = B.child2;
+            auto& D = nodes_[d];
+            auto& E = nodes_[e];
+
+            B.child1 = a;
+            B.parent = A.parent;
+            A.parent = b;
+
+            if (B.parent != NullProxy) {
+                auto& bp = nodes_[B.parent];
+                if (bp.child1 == a)
+                    bp.child1 = b;
+                else
+                    bp.child2 = b;
+            }
+            else {
+                root_ = b;
+            }
+
+            if (D.height > E.height) {
+                B.child2 = d;
+                A.child1 = e;
+                E.parent = a;
+                A.box = Aabb::merge(C.box, E.box);
+                B.box = Aabb::merge(A.box, D.box);
+                A.height = 1 + std::max(C.height, E.height);
+                B.height = 1 + std::max(A.height, D.height);
+            }
+            else {
+                B.child2 = e;
+                A.child1 = d;
+                D.parent = a;
+                A.box = Aabb::merge(C.box, D.box);
+                B.box = Aabb::merge(A.box, E.box);
+                A.height = 1 + std::max(C.height, D.height);
+                B.height = 1 + std::max(A.height, E.height);
+            }
+            return b;
+        }
+
+        return a;
+    }
+
+}
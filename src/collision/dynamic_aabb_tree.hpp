@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "raylib.h"
+
+namespace rlge {
+
+    // Dynamic bounding volume hierarchy, after the b2DynamicTree from Box2D.
+    // Leaves store fattened bounds, so a proxy is only reinserted once its collider leaves the fat box.
+    // Internal nodes are kept balanced with AVL-style rotations. Candidate pairs persist between frames and
+    // only proxies that were reinserted are queried again, so the per-frame cost follows the amount of movement.
+    class DynamicAabbTree final : public BroadPhase {
+    public:
+        explicit DynamicAabbTree(const BroadPhaseConfig& config = {});
+
+        ProxyId createProxy(Collider* collider, const Rectangle& bounds) override;
+        void destroyProxy(ProxyId proxy) override;
+        void moveProxy(ProxyId proxy, const Rectangle& bounds) override;
+        void collectPairs(std::vector<ColliderPair>& out) override;
+        void query(const Aabb& box, std::vector<Collider*>& out) const override;
+        void configure(const BroadPhaseConfig& config) override;
+
+        // Calls fn(proxy) for every leaf whose fat bounds overlap the box. Returning false from fn stops the query.
+        template <typename Fn>
+        void query(const Aabb& box, Fn&& fn) const;
+
+        [[nodiscard]] Collider* collider(const ProxyId proxy) const { return nodes_[proxy].collider; }
+        [[nodiscard]] const Aabb& fatBounds(const ProxyId proxy) const { return nodes_[proxy].box; }
+        [[nodiscard]] std::int32_t height() const { return root_ == NullProxy ? 0 : nodes_[root_].height; }
+
+    private:
+        struct Node {
+            Aabb box;
+            Aabb tight;
+            Collider* collider = nullptr;
+            ProxyId parent = NullProxy; // next free node while unused
+            ProxyId child1 = NullProxy;
+            ProxyId child2 = NullProxy;
+            std::int32_t height = -1;   // -1 marks a free node, 0 a leaf
+            bool touched = false;
+
+            [[nodiscard]] bool isLeaf() const { return child1 == NullProxy; }
+        };
+
+        struct ProxyPair {
+            ProxyId a;
+            ProxyId b;
+        };
+
+        ProxyId allocateNode_();
+        void freeNode_(ProxyId node);
+        void insertLeaf_(ProxyId leaf);
+        void removeLeaf_(ProxyId leaf);
+        ProxyId balance_(ProxyId a);
+        void refit_(ProxyId node);
+        [[nodiscard]] Aabb fatten_(const Aabb& tight, float dx, float dy) const;
+        void touch_(ProxyId proxy);
+
+        std::vector<Node> nodes_;
+        ProxyId root_ = NullProxy;
+        ProxyId freeList_ = NullProxy;
+        float margin_;
+        float displacementMultiplier_;
+
+        std::vector<ProxyId> moved_;
+        std::vector<ProxyPair> pairs_;
+        mutable std::vector<ProxyId> stack_;
+    };
+
+    template <typename Fn>
+    void DynamicAabbTree::query(const Aabb& box, Fn&& fn) const {
+        if (root_ == NullProxy)
+            return;
+
+        stack_.clear();
+        stack_.push_back(root_);
+        while (!stack_.empty()) {
+            const ProxyId id = stack_.back();
+            stack_.pop_back();
+
+            const auto& node = nodes_[id];
+            if (!node.box.overlaps(box))
+                continue;
+
+            if (node.isLeaf()) {
+                if (!fn(id))
+                    return;
+            }
+            else {
+                stack_.push_back(node.child1);
+                stack_.push_back(node.child2);
+            }
+        }
+    }
+
+}
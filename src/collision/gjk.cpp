@@ -0,0 +1,493 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "narrow_phase.hpp"
+#include "raymath.h"
+
+// GJK distance (after Box2D's b2Distance) and EPA penetration for support-mapped convex shapes.
+// Both run on the Minkowski difference B - A of the shapes' cores; the radii are added at the end.
+
+namespace rlge::narrow_phase {
+
+    namespace {
+        constexpr int maxGjkIterations = 32;
+        constexpr int maxEpaIterations = 32;
+        constexpr int maxCastIterations = 32;
+        // Separation at which a cast counts as touching, in world units
+        constexpr float castTolerance = 1e-3f;
+        constexpr std::size_t maxEpaVertices = 64;
+        constexpr float epaTolerance = 1e-4f;
+        constexpr float epsilon = 1e-6f;
+        constexpr float touchTolerance = 1e-5f;
+
+        float cross(const Vector2 a, const Vector2 b) { return a.x * b.y - a.y * b.x; }
+
+        std::size_t supportIndex(const std::span<const Vector2> core, const Vector2 d) {
+            std::size_t best = 0;
+            float bestDot = Vector2DotProduct(core[0], d);
+            for (std::size_t i = 1; i < core.size(); ++i) {
+                const float dot = Vector2DotProduct(core[i], d);
+                if (dot > bestDot) {
+                    bestDot = dot;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        struct SimplexVertex {
+            Vector2 wA;         // support point on A
+            Vector2 wB;         // support point on B
+            Vector2 w;          // wB - wA
+            float a;            // barycentric weight of the closest point
+            std::size_t indexA;
+            std::size_t indexB;
+        };
+
+        // Support of B - A in direction d, with A's core translated by offsetA
+        SimplexVertex makeVertex(const ConvexSupport& a, const ConvexSupport& b, const Vector2 d,
+                                 const Vector2 offsetA = {0.0f, 0.0f}) {
+            const auto ia = supportIndex(a.core, Vector2Negate(d));
+            const auto ib = supportIndex(b.core, d);
+            const auto wA = Vector2Add(a.core[ia], offsetA);
+            return {wA, b.core[ib], Vector2Subtract(b.core[ib], wA), 1.0f, ia, ib};
+        }
+
+        struct Simplex {
+            std::array<SimplexVertex, 3> v;
+            int count = 0;
+
+            // Closest point of the segment to the origin
+            void solve2() {
+                const auto w1 = v[0].w;
+                const auto w2 = v[1].w;
+                const auto e12 = Vector2Subtract(w2, w1);
+
+                const float d12_2 = -Vector2DotProduct(w1, e12);
+                if (d12_2 <= 0.0f) {
+                    v[0].a = 1.0f;
+                    count = 1;
+                    return;
+                }
+
+                const float d12_1 = Vector2DotProduct(w2, e12);
+                if (d12_1 <= 0.0f) {
+                    v[1].a = 1.0f;
+                    count = 1;
+                    v[0] = v[1];
+                    return;
+                }
+
+                const float inv = 1.0f / (d12_1 + d12_2);
+                v[0].a = d12_1 * inv;
+                v[1].a = d12_2 * inv;
+                count = 2;
+            }
+
+            // Closest feature of the triangle to the origin, by Voronoi regions
+            void solve3() {
+                const auto w1 = v[0].w;
+                const auto w2 = v[1].w;
+                const auto w3 = v[2].w;
+
+                const auto e12 = Vector2Subtract(w2, w1);
+                const float d12_1 = Vector2DotProduct(w2, e12);
+                const float d12_2 = -Vector2DotProduct(w1, e12);
+
+                const auto e13 = Vector2Subtract(w3, w1);
+                const float d13_1 = Vector2DotProduct(w3, e13);
+                const float d13_2 = -Vector2DotProduct(w1, e13);
+
+                const auto e23 = Vector2Subtract(w3, w2);
+                const float d23_1 = Vector2DotProduct(w3, e23);
+                const float d23_2 = -Vector2DotProduct(w2, e23);
+
+                const float n123 = cross(e12, e13);
+                const float d123_1 = n123 * cross(w2, w3);
+                const float d123_2 = n123 * cross(w3, w1);
+                const float d123_3 = n123 * cross(w1, w2);
+
+                if (d12_2 <= 0.0f && d13_2 <= 0.0f) {
+                    v[0].a = 1.0f;
+                    count = 1;
+                    return;
+                }
+
+                if (d12_1 > 0.0f && d12_2 > 0.0f && d123_3 <= 0.0f) {
+                    const float inv = 1.0f / (d12_1 + d12_2);
+                    v[0].a = d12_1 * inv;
+                    v[1].a = d12_2 * inv;
+                    count = 2;
+                    return;
+                }
+
+                if (d13_1 > 0.0f && d13_2 > 0.0f && d123_2 <= 0.0f) {
+                    const float inv = 1.0f / (d13_1 + d13_2);
+                    v[0].a = d13_1 * inv;
+                    v[2].a = d13_2 * inv;
+                    count = 2;
+                    v[1] = v[2];
+                    return;
+                }
+
+                if (d12_1 <= 0.0f && d23_2 <= 0.0f) {
+                    v[1].a = 1.0f;
+                    count = 1;
+                    v[0] = v[1];
+                    return;
+                }
+
+                if (d13_1 <= 0.0f && d23_1 <= 0.0f) {
+                    v[2].a = 1.0f;
+                    count = 1;
+                    v[0] = v[2];
+                    return;
+                }
+
+                if (d23_1 > 0.0f && d23_2 > 0.0f && d123_1 <= 0.0f) {
+                    const float inv = 1.0f / (d23_1 + d23_2);
+                    v[1].a = d23_1 * inv;
+                    v[2].a = d23_2 * inv;
+                    count = 2;
+                    v[0] = v[2];
+                    return;
+                }
+
+                // The origin is inside the triangle
+                const float inv = 1.0f / (d123_1 + d123_2 + d123_3);
+                v[0].a = d123_1 * inv;
+                v[1].a = d123_2 * inv;
+                v[2].a = d123_3 * inv;
+                count = 3;
+            }
+
+            [[nodiscard]] Vector2 searchDirection() const {
+                if (count == 1)
+                    return Vector2Negate(v[0].w);
+
+                const auto e12 = Vector2Subtract(v[1].w, v[0].w);
+                // Perpendicular of the edge on the origin's side
+                if (cross(e12, Vector2Negate(v[0].w)) > 0.0f)
+                    return Vector2{-e12.y, e12.x};
+                return Vector2{e12.y, -e12.x};
+            }
+
+            // Largest coordinate of the simplex, for tolerances that follow the magnitude of the inputs
+            [[nodiscard]] float scale() const {
+                float s = 1.0f;
+                for (int i = 0; i < count; ++i) {
+                    s = std::max({s, std::fabs(v[i].w.x), std::fabs(v[i].w.y)});
+                }
+                return s;
+            }
+
+            void witnessPoints(Vector2& pA, Vector2& pB) const {
+                pA = Vector2{0.0f, 0.0f};
+                pB = Vector2{0.0f, 0.0f};
+                for (int i = 0; i < count; ++i) {
+                    pA = Vector2Add(pA, Vector2Scale(v[i].wA, v[i].a));
+                    pB = Vector2Add(pB, Vector2Scale(v[i].wB, v[i].a));
+                }
+            }
+        };
+
+        // Runs GJK on the cores, A translated by offsetA. Returns false when they overlap (the origin is inside
+        // B - A), otherwise the closest points on both cores.
+        bool gjk(const ConvexSupport& a, const ConvexSupport& b, Simplex& simplex, Vector2& pA, Vector2& pB,
+                 const Vector2 offsetA = {0.0f, 0.0f}) {
+            auto initial = Vector2Subtract(b.center, Vector2Add(a.center, offsetA));
+            if (Vector2DotProduct(initial, initial) < epsilon * epsilon)
+                initial = Vector2{1.0f, 0.0f};
+            simplex.v[0] = makeVertex(a, b, initial, offsetA);
+            simplex.count = 1;
+
+            for (int iteration = 0; iteration < maxGjkIterations; ++iteration) {
+                std::array<std::size_t, 3> savedA{};
+                std::array<std::size_t, 3> savedB{};
+                const int savedCount = simplex.count;
+                for (int i = 0; i < savedCount; ++i) {
+                    savedA[i] = simplex.v[i].indexA;
+                    savedB[i] = simplex.v[i].indexB;
+                }
+
+                if (simplex.count == 2)
+                    simplex.solve2();
+                else if (simplex.count == 3)
+                    simplex.solve3();
+
+                if (simplex.count == 3)
+                    return false;
+
+                const auto d = simplex.searchDirection();
+                if (Vector2DotProduct(d, d) < epsilon * epsilon)
+                    // The origin lies on the simplex: the cores touch or overlap
+                    return false;
+
+                const auto vertex = makeVertex(a, b, d, offsetA);
+
+                // A repeated support point means no further progress is possible
+                bool duplicate = false;
+                for (int i = 0; i < savedCount; ++i) {
+                    if (vertex.indexA == savedA[i] && vertex.indexB == savedB[i]) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate)
+                    break;
+
+                simplex.v[simplex.count++] = vertex;
+            }
+
+            simplex.witnessPoints(pA, pB);
+            return true;
+        }
+
+        Vector2 fallbackNormal(const ConvexSupport& a, const ConvexSupport& b) {
+            const auto dir = Vector2Subtract(b.center, a.center);
+            const float len = Vector2Length(dir);
+            return len > epsilon ? Vector2Scale(dir, 1.0f / len) : Vector2{1.0f, 0.0f};
+        }
+
+        Vector2 supportPoint(const ConvexSupport& a, const ConvexSupport& b, const Vector2 d) {
+            return makeVertex(a, b, d).w;
+        }
+
+        // Expands the terminating GJK simplex into a polytope around the origin and grows it towards the face of
+        // B - A closest to the origin. Returns false when B - A has no area (the shapes can only touch).
+        bool epa(const ConvexSupport& a, const ConvexSupport& b, const Simplex& simplex, Vector2& outNormal,
+                 float& outDepth) {
+            std::array<Vector2, maxEpaVertices> poly{};
+            std::size_t n = 0;
+
+            const float flat = epsilon * simplex.scale();
+            if (simplex.count == 3) {
+                for (int i = 0; i < 3; ++i) {
+                    poly[n++] = simplex.v[i].w;
+                }
+            }
+            else {
+                // GJK stopped with the origin on a vertex or an edge of the simplex. Grow that into a polytope
+                // that keeps the origin inside or on its boundary; EPA then only has to expand it.
+                auto w0 = simplex.v[0].w;
+                auto w1 = simplex.count == 2 ? simplex.v[1].w : w0;
+                if (simplex.count == 1) {
+                    constexpr Vector2 axes[4] = {{1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f}};
+                    for (const auto& axis : axes) {
+                        w1 = supportPoint(a, b, axis);
+                        if (Vector2DotProduct(Vector2Subtract(w1, w0), axis) > flat)
+                            break;
+                    }
+                    if (Vector2DistanceSqr(w0, w1) <= flat * flat)
+                        // B - A is a single point
+                        return false;
+                }
+
+                const auto e = Vector2Subtract(w1, w0);
+                const Vector2 perp{-e.y, e.x};
+                const auto p = supportPoint(a, b, perp);
+                const auto q = supportPoint(a, b, Vector2Negate(perp));
+                const bool hasP = Vector2DotProduct(Vector2Subtract(p, w0), perp) > flat * Vector2Length(perp);
+                const bool hasQ = Vector2DotProduct(Vector2Subtract(w0, q), perp) > flat * Vector2Length(perp);
+                if (!hasP && !hasQ)
+                    // B - A is flat, so the shapes can only touch
+                    return false;
+
+                poly[n++] = w0;
+                if (hasP)
+                    poly[n++] = p;
+                poly[n++] = w1;
+                if (hasQ)
+                    poly[n++] = q;
+            }
+
+            // Counter-clockwise winding, so (e.y, -e.x) is the outward edge normal
+            float area = 0.0f;
+            for (std::size_t i = 0; i < n; ++i) {
+                area += cross(poly[i], poly[(i + 1) % n]);
+            }
+            if (area < 0.0f) {
+                std::reverse(poly.begin(), poly.begin() + static_cast<std::ptrdiff_t>(n));
+            }
+
+            Vector2 bestNormal{0.0f, 0.0f};
+            float bestDistance = 0.0f;
+            for (int iteration = 0; iteration < maxEpaIterations; ++iteration) {
+                std::size_t bestEdge = 0;
+                bestDistance = std::numeric_limits<float>::max();
+                for (std::size_t i = 0; i < n; ++i) {
+                    const auto e = Vector2Subtract(poly[(i + 1) % n], poly[i]);
+                    const float len = Vector2Length(e);
+                    if (len <= epsilon)
+                        continue;
+                    const Vector2 normal{e.y / len, -e.x / len};
+                    const float distance = Vector2DotProduct(normal, poly[i]);
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        bestNormal = normal;
+                        bestEdge = i;
+                    }
+                }
+
+                const auto support = supportPoint(a, b, bestNormal);
+                if (Vector2DotProduct(support, bestNormal) - bestDistance <= epaTolerance || n == maxEpaVertices)
+                    break;
+
+                // Split the closest edge at the new support point
+                for (auto i = n; i > bestEdge + 1; --i) {
+                    poly[i] = poly[i - 1];
+                }
+                poly[bestEdge + 1] = support;
+                ++n;
+            }
+
+            outNormal = bestNormal;
+            outDepth = bestDistance;
+            return true;
+        }
+    }
+
+    CollisionManifold convex(const ConvexSupport& a, const ConvexSupport& b) {
+        CollisionManifold m{};
+        if (a.core.empty() || b.core.empty()) {
+            m.colliding = false;
+            return m;
+        }
+
+        const float radii = a.radius + b.radius;
+        Simplex simplex;
+        Vector2 pA;
+        Vector2 pB;
+        if (gjk(a, b, simplex, pA, pB)) {
+            const auto delta = Vector2Subtract(pB, pA);
+            const float distance = Vector2Length(delta);
+            // Below the tolerance the origin is on the simplex up to rounding, and GJK may have stopped early
+            if (distance > touchTolerance * simplex.scale()) {
+                // Disjoint cores: only the radii can make the shapes touch
+                if (distance >= radii) {
+                    m.colliding = false;
+                    return m;
+                }
+                m.colliding = true;
+                m.normal = Vector2Scale(delta, 1.0f / distance);
+                m.depth = radii - distance;
+                return m;
+            }
+            // Touching cores are handled like overlapping ones
+        }
+
+        Vector2 normal;
+        float depth;
+        if (!epa(a, b, simplex, normal, depth)) {
+            if (radii <= 0.0f) {
+                // Polygons touching along an edge or at a vertex
+                m.colliding = false;
+                return m;
+            }
+            normal = Vector2Negate(fallbackNormal(a, b));
+            depth = 0.0f;
+        }
+
+        // EPA's normal is the outward face normal of B - A; B leaves the overlap by moving against it.
+        m.colliding = true;
+        m.normal = Vector2Negate(normal);
+        m.depth = depth + radii;
+        return m;
+    }
+
+    bool convexOverlap(const ConvexSupport& a, const ConvexSupport& b) {
+        if (a.core.empty() || b.core.empty())
+            return false;
+
+        const float radii = a.radius + b.radius;
+        Simplex simplex;
+        Vector2 pA;
+        Vector2 pB;
+        if (gjk(a, b, simplex, pA, pB)) {
+            const float distanceSq = Vector2DistanceSqr(pA, pB);
+            const float touching = touchTolerance * simplex.scale();
+            if (distanceSq > touching * touching)
+                return distanceSq < radii * radii;
+        }
+
+        // The cores touch or overlap. Without radii, shapes whose Minkowski difference is flat only touch, which
+        // is what EPA rejects; a full triangle around the origin always has area.
+        if (radii > 0.0f || simplex.count == 3)
+            return true;
+        Vector2 normal;
+        float depth;
+        return epa(a, b, simplex, normal, depth);
+    }
+
+    bool cast(const ConvexSupport& a, const ConvexSupport& b, const Vector2 motion, CastHit& hit) {
+        if (a.core.empty() || b.core.empty())
+            return false;
+
+        // Conservative advancement: move A towards B by the current gap over the closing speed along the
+        // separating direction. For a pure translation this never steps past the first contact.
+        const float radii = a.radius + b.radius;
+        float t = 0.0f;
+        Vector2 previous{0.0f, 0.0f}; // separating direction of the last step, zero before the first
+        for (int iteration = 0; iteration < maxCastIterations; ++iteration) {
+            Simplex simplex;
+            Vector2 pA;
+            Vector2 pB;
+            const bool separated = gjk(a, b, simplex, pA, pB, Vector2Scale(motion, t));
+            const auto delta = Vector2Subtract(pB, pA);
+            const float distance = Vector2Length(delta);
+            if (!separated || distance <= touchTolerance * simplex.scale()) {
+                if (t > 0.0f) {
+                    // Shapes without radius advance until their cores touch, where the closest points no longer
+                    // give a direction; the last step's separating direction is the contact normal.
+                    hit.fraction = t;
+                    hit.normal = Vector2Negate(previous);
+                    hit.point = Vector2Subtract(pB, Vector2Scale(previous, b.radius));
+                    return true;
+                }
+                // Cores overlap, which only happens when A already started inside B
+                const float length = Vector2Length(motion);
+                hit.fraction = t;
+                hit.normal = length > epsilon ? Vector2Scale(motion, -1.0f / length) : Vector2{0.0f, 0.0f};
+                hit.point = Vector2Add(a.center, Vector2Scale(motion, t));
+                return true;
+            }
+
+            const auto normal = Vector2Scale(delta, 1.0f / distance);
+            previous = normal;
+            const float gap = distance - radii;
+            if (gap <= castTolerance) {
+                hit.fraction = t;
+                hit.normal = Vector2Negate(normal);
+                hit.point = Vector2Subtract(pB, Vector2Scale(normal, b.radius));
+                return true;
+            }
+
+            const float closing = Vector2DotProduct(motion, normal);
+            if (closing <= epsilon)
+                // Moving apart or sliding past
+                return false;
+            t += (gap - castTolerance * 0.5f) / closing;
+            if (t > 1.0f)
+                return false;
+        }
+        return false;
+    }
+
+    Rectangle bounds(const ConvexSupport& s) {
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest();
+        float maxY = std::numeric_limits<float>::lowest();
+        for (const auto& p : s.core) {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+        return Rectangle{minX - s.radius, minY - s.radius, maxX - minX + 2.0f * s.radius,
+                         maxY - minY + 2.0f * s.radius};
+    }
+
+}
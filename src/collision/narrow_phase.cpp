@@ -1,6 +1,6 @@
 #include "narrow_phase.hpp"
 
-#include <vector>
+#include <span>
 
 #include "raylib.h"
 #include "raymath.h"
@@ -11,22 +11,49 @@
 
 namespace rlge::narrow_phase {
 
-    static void projectPoints(const std::vector<Vector2>& pts, const Vector2 axis, float& outMin, float& outMax) {
-        const float len = Vector2Length(axis);
-        if (len == 0.0f || pts.empty()) {
+    // Polygon as seen by the SAT helpers: either the inline copy in the geometry cache or, for polygons with
+    // more than ConvexShape::capacity vertices, the cache's vectors.
+    struct PolygonView {
+        std::span<const Vector2> points;
+        std::span<const Vector2> normals;
+        Vector2 center;
+    };
+
+    static Vector2 polygonCenter(const std::span<const Vector2> pts) {
+        Vector2 c{0.0f, 0.0f};
+        if (pts.empty()) {
+            return c;
+        }
+
+        for (const auto& p : pts) {
+            c = Vector2Add(c, p);
+        }
+
+        const float inv = 1.0f / static_cast<float>(pts.size());
+        return Vector2Scale(c, inv);
+    }
+
+    static PolygonView polygonOf(const ColliderGeometry& g) {
+        if (g.convex.count > 0) {
+            return {g.convex.vertices(), g.convex.edgeNormals(), g.convex.center};
+        }
+        return {g.points, g.normals, polygonCenter(g.points)};
+    }
+
+    // Projects points onto a unit-length axis.
+    static void projectPoints(const std::span<const Vector2> pts, const Vector2 axis, float& outMin, float& outMax) {
+        if (pts.empty()) {
             outMin = 0.0f;
             outMax = 0.0f;
             return;
         }
 
-        const Vector2 nAxis = Vector2Scale(axis, 1.0f / len);
-
-        float minProj = Vector2DotProduct(pts[0], nAxis);
+        float minProj = Vector2DotProduct(pts[0], axis);
         float maxProj = minProj;
 
         const size_t count = pts.size();
         for (size_t i = 1; i < count; ++i) {
-            const float p = Vector2DotProduct(pts[i], nAxis);
+            const float p = Vector2DotProduct(pts[i], axis);
             if (p < minProj) {
                 minProj = p;
             } else if (p > maxProj) {
@@ -38,52 +65,26 @@ namespace rlge::narrow_phase {
         outMax = maxProj;
     }
 
-    static Vector2 polygonCenter(const std::vector<Vector2>& pts) {
-        Vector2 c{0.0f, 0.0f};
-        if (pts.empty()) {
-            return c;
-        }
-
-        for (const auto& p : pts) {
-            c = Vector2Add(c, p);
-        }
-
-        const float inv = 1.0f / static_cast<float>(pts.size());
-        return Vector2Scale(c, inv);
-    }
-
+    // Projects a circle onto a unit-length axis.
     static void projectCircle(Vector2 center, float radius, Vector2 axis, float& outMin, float& outMax) {
-        const float len = Vector2Length(axis);
-        if (len == 0.0f) {
-            outMin = 0.0f;
-            outMax = 0.0f;
-            return;
-        }
-
-        const Vector2 nAxis = Vector2Scale(axis, 1.0f / len);
-        const float centerProj = Vector2DotProduct(center, nAxis);
+        const float centerProj = Vector2DotProduct(center, axis);
         outMin = centerProj - radius;
         outMax = centerProj + radius;
     }
 
-    static bool satTestEdges(const std::vector<Vector2>& a,
-                             const std::vector<Vector2>& b,
-                             const std::vector<Vector2>& pts,
+    // Tests the edge normals of one shape as separating axes. Normals come precomputed and normalized
+    // from the collider geometry cache; degenerate edges carry a zero normal and are skipped.
+    static bool satTestEdges(const std::span<const Vector2> a,
+                             const std::span<const Vector2> b,
+                             const std::span<const Vector2> normals,
                              bool& ioHasAxis,
                              float& ioBestDepth,
                              Vector2& ioBestAxis) {
-        const size_t count = pts.size();
-        for (size_t i = 0; i < count; ++i) {
-            const Vector2 p0 = pts[i];
-            const Vector2 p1 = pts[(i + 1) % count];
-            const Vector2 edge = Vector2Subtract(p1, p0);
-
-            if (Vector2Length(edge) == 0.0f) {
+        for (const auto& axis : normals) {
+            if (axis.x == 0.0f && axis.y == 0.0f) {
                 continue;
             }
 
-            Vector2 axis{-edge.y, edge.x};
-
             float minA, maxA;
             float minB, maxB;
             projectPoints(a, axis, minA, maxA);
@@ -97,25 +98,47 @@ namespace rlge::narrow_phase {
             if (!ioHasAxis || overlap < ioBestDepth) {
                 ioHasAxis = true;
                 ioBestDepth = overlap;
-                const float len = Vector2Length(axis);
-                ioBestAxis = Vector2Scale(axis, 1.0f / len);
+                ioBestAxis = axis;
             }
         }
         return true;
     }
 
-    static bool satPolygons(const std::vector<Vector2>& a,
-                            const std::vector<Vector2>& b,
+    // Early-out counterpart of satTestEdges. ioHasAxis records whether any usable axis was seen.
+    static bool satSeparated(const std::span<const Vector2> a,
+                             const std::span<const Vector2> b,
+                             const std::span<const Vector2> normals,
+                             bool& ioHasAxis) {
+        for (const auto& axis : normals) {
+            if (axis.x == 0.0f && axis.y == 0.0f) {
+                continue;
+            }
+
+            float minA, maxA;
+            float minB, maxB;
+            projectPoints(a, axis, minA, maxA);
+            projectPoints(b, axis, minB, maxB);
+            ioHasAxis = true;
+
+            if (maxA < minB || maxB < minA) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool satPolygons(const PolygonView& a,
+                            const PolygonView& b,
                             float& outDepth,
                             Vector2& outAxis) {
         auto hasAxis = false;
         auto bestDepth = 0.0f;
         Vector2 bestAxis{0.0f, 0.0f};
 
-        if (!satTestEdges(a, b, a, hasAxis, bestDepth, bestAxis)) {
+        if (!satTestEdges(a.points, b.points, a.normals, hasAxis, bestDepth, bestAxis)) {
             return false;
         }
-        if (!satTestEdges(a, b, b, hasAxis, bestDepth, bestAxis)) {
+        if (!satTestEdges(a.points, b.points, b.normals, hasAxis, bestDepth, bestAxis)) {
             return false;
         }
 
@@ -128,26 +151,27 @@ namespace rlge::narrow_phase {
         return true;
     }
 
-    static CollisionManifold polygonCollisionFromPoints(const std::vector<Vector2>& ptsA,
-                                                        const std::vector<Vector2>& ptsB) {
+    static CollisionManifold polygonCollisionFromPoints(const ColliderGeometry& geometryA,
+                                                        const ColliderGeometry& geometryB) {
         CollisionManifold m{};
 
-        if (ptsA.size() < 3 || ptsB.size() < 3) {
+        if (geometryA.points.size() < 3 || geometryB.points.size() < 3) {
             m.colliding = false;
             return m;
         }
 
+        const auto a = polygonOf(geometryA);
+        const auto b = polygonOf(geometryB);
+
         float depth = 0.0f;
         Vector2 axis{0.0f, 0.0f};
 
-        if (!satPolygons(ptsA, ptsB, depth, axis)) {
+        if (!satPolygons(a, b, depth, axis)) {
             m.colliding = false;
             return m;
         }
 
-        const Vector2 centerA = polygonCenter(ptsA);
-        const Vector2 centerB = polygonCenter(ptsB);
-        const Vector2 dir = Vector2Subtract(centerB, centerA);
+        const Vector2 dir = Vector2Subtract(b.center, a.center);
 
         if (Vector2DotProduct(axis, dir) < 0.0f) {
             axis = Vector2Negate(axis);
@@ -159,6 +183,41 @@ namespace rlge::narrow_phase {
         return m;
     }
 
+    CollisionManifold polygonSat(const ColliderGeometry& a, const ColliderGeometry& b) {
+        return polygonCollisionFromPoints(a, b);
+    }
+
+    // SAT costs O(n * m) projections, GJK O(n + m) per iteration; past the inline vertex capacity GJK wins.
+    static CollisionManifold polygonCollision(const ColliderGeometry& a, const ColliderGeometry& b) {
+        if (a.convex.count > 0 && b.convex.count > 0)
+            return polygonCollisionFromPoints(a, b);
+        if (a.points.size() < 3 || b.points.size() < 3)
+            return CollisionManifold{};
+        return convex(ConvexSupport{a.points, 0.0f, polygonOf(a).center},
+                      ConvexSupport{b.points, 0.0f, polygonOf(b).center});
+    }
+
+    static bool polygonOverlap(const ColliderGeometry& a, const ColliderGeometry& b) {
+        if (a.points.size() < 3 || b.points.size() < 3)
+            return false;
+
+        if (a.convex.count > 0 && b.convex.count > 0) {
+            const auto pa = a.convex.vertices();
+            const auto pb = b.convex.vertices();
+            bool hasAxis = false;
+            if (satSeparated(pa, pb, a.convex.edgeNormals(), hasAxis) ||
+                satSeparated(pa, pb, b.convex.edgeNormals(), hasAxis))
+                return false;
+            return hasAxis;
+        }
+
+        // Like polygonCollision, large polygons go through GJK; the bounds center is good enough to seed it.
+        const auto center = [](const ColliderGeometry& g) {
+            return Vector2{g.bounds.x + g.bounds.width * 0.5f, g.bounds.y + g.bounds.height * 0.5f};
+        };
+        return convexOverlap(ConvexSupport{a.points, 0.0f, center(a)}, ConvexSupport{b.points, 0.0f, center(b)});
+    }
+
     CollisionManifold boxBox(const BoxCollider& a, const BoxCollider& b) {
         CollisionManifold m;
         const Rectangle A = a.axisAlignedWorldBounds();
@@ -270,9 +329,35 @@ namespace rlge::narrow_phase {
         return m;
     }
 
-    static CollisionManifold polygonCircleFromPoints(const std::vector<Vector2>& pts,
+    bool boxBoxOverlap(const BoxCollider& a, const BoxCollider& b) {
+        return CheckCollisionRecs(a.axisAlignedWorldBounds(), b.axisAlignedWorldBounds());
+    }
+
+    bool boxCircleOverlap(const BoxCollider& box, const CircleCollider& c) {
+        const auto b = box.axisAlignedWorldBounds();
+        const auto center = c.center();
+        const auto radius = c.radius();
+
+        const auto closest = Vector2Clamp(
+            center,
+            Vector2{b.x, b.y},
+            Vector2{b.x + b.width, b.y + b.height});
+
+        const auto diff = center - closest;
+        return Vector2DotProduct(diff, diff) <= radius * radius;
+    }
+
+    bool circleCircleOverlap(const CircleCollider& a, const CircleCollider& b) {
+        const auto d = b.center() - a.center();
+        const auto rSum = a.radius() + b.radius();
+        return Vector2DotProduct(d, d) < rSum * rSum;
+    }
+
+    static CollisionManifold polygonCircleFromPoints(const ColliderGeometry& poly,
                                                      const CircleCollider& c) {
         CollisionManifold m{};
+        const auto view = polygonOf(poly);
+        const auto pts = view.points;
 
         if (pts.size() < 3) {
             m.colliding = false;
@@ -288,17 +373,11 @@ namespace rlge::narrow_phase {
 
         // Polygon edge normals
         const size_t count = pts.size();
-        for (size_t i = 0; i < count; ++i) {
-            const Vector2 p0 = pts[i];
-            const Vector2 p1 = pts[(i + 1) % count];
-            const Vector2 edge = Vector2Subtract(p1, p0);
-
-            if (Vector2Length(edge) == 0.0f) {
+        for (const auto& axis : view.normals) {
+            if (axis.x == 0.0f && axis.y == 0.0f) {
                 continue;
             }
 
-            Vector2 axis{-edge.y, edge.x};
-
             float minPoly, maxPoly;
             projectPoints(pts, axis, minPoly, maxPoly);
 
@@ -316,8 +395,7 @@ namespace rlge::narrow_phase {
             if (!hasAxis || overlap < bestDepth) {
                 hasAxis = true;
                 bestDepth = overlap;
-                const float len = Vector2Length(axis);
-                bestAxis = Vector2Scale(axis, 1.0f / len);
+                bestAxis = axis;
             }
         }
 
@@ -334,8 +412,10 @@ namespace rlge::narrow_phase {
             }
         }
 
-        Vector2 vertexAxis = Vector2Subtract(center, closestVertex);
-        if (Vector2Length(vertexAxis) > 0.0f) {
+        const Vector2 vertexDelta = Vector2Subtract(center, closestVertex);
+        const float vertexDist = Vector2Length(vertexDelta);
+        if (vertexDist > 0.0f) {
+            const Vector2 vertexAxis = Vector2Scale(vertexDelta, 1.0f / vertexDist);
             float minPoly, maxPoly;
             projectPoints(pts, vertexAxis, minPoly, maxPoly);
 
@@ -353,8 +433,7 @@ namespace rlge::narrow_phase {
             if (!hasAxis || overlap < bestDepth) {
                 hasAxis = true;
                 bestDepth = overlap;
-                const float len = Vector2Length(vertexAxis);
-                bestAxis = Vector2Scale(vertexAxis, 1.0f / len);
+                bestAxis = vertexAxis;
             }
         }
 
@@ -363,8 +442,7 @@ namespace rlge::narrow_phase {
             return m;
         }
 
-        const Vector2 polyCenter = polygonCenter(pts);
-        const Vector2 dir = Vector2Subtract(center, polyCenter);
+        const Vector2 dir = Vector2Subtract(center, view.center);
         if (Vector2DotProduct(bestAxis, dir) < 0.0f) {
             bestAxis = Vector2Negate(bestAxis);
         }
@@ -375,20 +453,83 @@ namespace rlge::narrow_phase {
         return m;
     }
 
+    static bool polygonCircleOverlap(const ColliderGeometry& poly, const CircleCollider& c) {
+        const bool inlined = poly.convex.count > 0;
+        const auto pts = inlined ? poly.convex.vertices() : std::span<const Vector2>(poly.points);
+        const auto normals = inlined ? poly.convex.edgeNormals() : std::span<const Vector2>(poly.normals);
+
+        if (pts.size() < 3) {
+            return false;
+        }
+
+        const Vector2 center = c.center();
+        const float radius = c.radius();
+        bool hasAxis = false;
+
+        for (const auto& axis : normals) {
+            if (axis.x == 0.0f && axis.y == 0.0f) {
+                continue;
+            }
+
+            float minPoly, maxPoly;
+            projectPoints(pts, axis, minPoly, maxPoly);
+
+            float minCircle, maxCircle;
+            projectCircle(center, radius, axis, minCircle, maxCircle);
+            hasAxis = true;
+
+            if (maxPoly < minCircle || maxCircle < minPoly) {
+                return false;
+            }
+        }
+
+        float minDistSq = 0.0f;
+        Vector2 closestVertex{0.0f, 0.0f};
+        for (size_t i = 0; i < pts.size(); ++i) {
+            const Vector2 diff = Vector2Subtract(center, pts[i]);
+            const auto dSq = Vector2DotProduct(diff, diff);
+            if (i == 0 || dSq < minDistSq) {
+                minDistSq = dSq;
+                closestVertex = pts[i];
+            }
+        }
+
+        // The axis towards the nearest vertex stays unnormalized: the circle reaches radius * |axis| along it,
+        // so the gaps are compared squared instead of taking a square root.
+        const Vector2 axis = Vector2Subtract(center, closestVertex);
+        const float lengthSq = Vector2DotProduct(axis, axis);
+        if (lengthSq > 0.0f) {
+            float minPoly, maxPoly;
+            projectPoints(pts, axis, minPoly, maxPoly);
+            hasAxis = true;
+
+            const float centerProj = Vector2DotProduct(center, axis);
+            const float reachSq = radius * radius * lengthSq;
+            const float gapAbove = centerProj - maxPoly;
+            const float gapBelow = minPoly - centerProj;
+            if ((gapAbove > 0.0f && gapAbove * gapAbove > reachSq) ||
+                (gapBelow > 0.0f && gapBelow * gapBelow > reachSq)) {
+                return false;
+            }
+        }
+
+        return hasAxis;
+    }
+
     CollisionManifold boxObb(const ObbCollider& obb, const BoxCollider& box) {
-        return polygonCollisionFromPoints(obb.points(), box.points());
+        return polygonCollision(obb.geometry(), box.geometry());
     }
 
     CollisionManifold obbObb(const ObbCollider& a, const ObbCollider& b) {
-        return polygonCollisionFromPoints(a.points(), b.points());
+        return polygonCollision(a.geometry(), b.geometry());
     }
 
     CollisionManifold polyPoly(const PolygonCollider& a, const PolygonCollider& b) {
-        return polygonCollisionFromPoints(a.points(), b.points());
+        return polygonCollision(a.geometry(), b.geometry());
     }
 
     CollisionManifold polyCircle(const PolygonCollider& p, const CircleCollider& c) {
-        return polygonCircleFromPoints(p.points(), c);
+        return polygonCircleFromPoints(p.geometry(), c);
     }
 
     CollisionManifold polyBox(const PolygonCollider& p, const BoxCollider& b) {
@@ -396,15 +537,43 @@ namespace rlge::narrow_phase {
         // for the common case where the box is the moving collider. By
         // feeding the box points as the first argument, the SAT helper
         // orients the normal from box -> poly.
-        return polygonCollisionFromPoints(b.points(), p.points());
+        return polygonCollision(b.geometry(), p.geometry());
     }
 
     CollisionManifold obbPolygon(const ObbCollider& obb, const PolygonCollider& p) {
-        return polygonCollisionFromPoints(obb.points(), p.points());
+        return polygonCollision(obb.geometry(), p.geometry());
     }
 
     CollisionManifold obbCircle(const ObbCollider& obb, const CircleCollider& c) {
-        return polygonCircleFromPoints(obb.points(), c);
+        return polygonCircleFromPoints(obb.geometry(), c);
+    }
+
+    bool boxObbOverlap(const ObbCollider& obb, const BoxCollider& box) {
+        return polygonOverlap(obb.geometry(), box.geometry());
+    }
+
+    bool obbObbOverlap(const ObbCollider& a, const ObbCollider& b) {
+        return polygonOverlap(a.geometry(), b.geometry());
+    }
+
+    bool polyPolyOverlap(const PolygonCollider& a, const PolygonCollider& b) {
+        return polygonOverlap(a.geometry(), b.geometry());
+    }
+
+    bool polyCircleOverlap(const PolygonCollider& p, const CircleCollider& c) {
+        return polygonCircleOverlap(p.geometry(), c);
+    }
+
+    bool polyBoxOverlap(const PolygonCollider& p, const BoxCollider& b) {
+        return polygonOverlap(b.geometry(), p.geometry());
+    }
+
+    bool obbPolygonOverlap(const ObbCollider& obb, const PolygonCollider& p) {
+        return polygonOverlap(obb.geometry(), p.geometry());
+    }
+
+    bool obbCircleOverlap(const ObbCollider& obb, const CircleCollider& c) {
+        return polygonCircleOverlap(obb.geometry(), c);
     }
 
 }
@@ -8,6 +8,12 @@ namespace rlge {
     class ObbCollider;
 
     namespace narrow_phase {
+        // The same contact seen from the other shape.
+        inline CollisionManifold flipped(CollisionManifold m) {
+            m.normal = Vector2{-m.normal.x, -m.normal.y};
+            return m;
+        }
+
         CollisionManifold boxBox(const BoxCollider& a, const BoxCollider& b);
         CollisionManifold boxCircle(const BoxCollider& box, const CircleCollider& c);
         CollisionManifold circleCircle(const CircleCollider& a, const CircleCollider& b);
@@ -19,5 +25,44 @@ namespace rlge {
         CollisionManifold polyBox(const PolygonCollider& p, const BoxCollider& b);
         CollisionManifold obbPolygon(const ObbCollider& obb, const PolygonCollider& p);
         CollisionManifold obbCircle(const ObbCollider& obb, const CircleCollider& c);
+
+        // Overlap-only tests for pairs that need no manifold. Same answer as the manifold's `colliding`, but they
+        // stop at the first separating axis and never compute a depth, a normal or a centroid.
+        bool boxBoxOverlap(const BoxCollider& a, const BoxCollider& b);
+        bool boxCircleOverlap(const BoxCollider& box, const CircleCollider& c);
+        bool circleCircleOverlap(const CircleCollider& a, const CircleCollider& b);
+        bool boxObbOverlap(const ObbCollider& obb, const BoxCollider& box);
+        bool obbObbOverlap(const ObbCollider& a, const ObbCollider& b);
+        bool polyPolyOverlap(const PolygonCollider& a, const PolygonCollider& b);
+        bool polyCircleOverlap(const PolygonCollider& p, const CircleCollider& c);
+        bool polyBoxOverlap(const PolygonCollider& p, const BoxCollider& b);
+        bool obbPolygonOverlap(const ObbCollider& obb, const PolygonCollider& p);
+        bool obbCircleOverlap(const ObbCollider& obb, const CircleCollider& c);
+
+        // General convex path: GJK finds the distance between the cores, EPA the penetration when they overlap.
+        // The normal points from a to b.
+        CollisionManifold convex(const ConvexSupport& a, const ConvexSupport& b);
+        // GJK alone; EPA only runs for cores that exactly touch.
+        bool convexOverlap(const ConvexSupport& a, const ConvexSupport& b);
+        // Sweeps a along motion against a resting b. On a hit, fills fraction, point and normal (b's surface
+        // normal, facing a); shapes that already overlap report fraction 0. hit.collider is left untouched.
+        bool cast(const ConvexSupport& a, const ConvexSupport& b, Vector2 motion, CastHit& hit);
+        // World bounds of a support-mapped shape with a non-empty core.
+        Rectangle bounds(const ConvexSupport& s);
+
+        // Shape used by the continuous test: a circle when radius > 0, otherwise the box `bounds`.
+        struct SweptShape {
+            Rectangle bounds;
+            Vector2 center;
+            float radius;
+        };
+
+        // Time of impact of a moving by `motion` towards a resting b, both given at their start positions.
+        // On a hit, toi is the first contact time in [0, 1], the normal points from a to b and depth is the part
+        // of the remaining motion that drives a into b.
+        CollisionManifold timeOfImpact(const SweptShape& a, const SweptShape& b, Vector2 motion);
+
+        // Separating-axis test on two cached polygon geometries, normal pointing from a to b.
+        CollisionManifold polygonSat(const ColliderGeometry& a, const ColliderGeometry& b);
     }
 }
@@ -0,0 +1,44 @@
+#include "rigid_body.hpp"
+
+#include "collision_system.hpp"
+#include "raymath.h"
+
+namespace rlge {
+
+    RigidBody::RigidBody(Entity& e, CollisionSystem& system, Collider& collider, const float mass) :
+        Component(e), system_(system), collider_(&collider), mass_(mass) {
+        system_.registerBody(this);
+    }
+
+    RigidBody::~RigidBody() {
+        system_.unregisterBody(this);
+    }
+
+    void RigidBody::setVelocity(const Vector2 velocity) {
+        velocity_ = velocity;
+        wake();
+    }
+
+    void RigidBody::applyImpulse(const Vector2 impulse) {
+        if (isKinematic())
+            return;
+        velocity_ = Vector2Add(velocity_, Vector2Scale(impulse, 1.0f / mass_));
+        wake();
+    }
+
+    void RigidBody::applyForce(const Vector2 force) {
+        force_ = Vector2Add(force_, force);
+        wake();
+    }
+
+    void RigidBody::setMass(const float mass) {
+        mass_ = mass;
+        wake();
+    }
+
+    void RigidBody::wake() {
+        sleeping_ = false;
+        sleepTime_ = 0.0f;
+    }
+
+}
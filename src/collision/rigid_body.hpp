@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+
+#include "raylib.h"
+#include "../component.hpp"
+
+namespace rlge {
+    class Collider;
+    class CollisionSystem;
+    class Entity;
+    class Transform;
+
+    // Velocity, mass and surface response for an entity with a collider. The CollisionSystem integrates bodies
+    // at a fixed substep and resolves their solid contacts with impulses, so they bounce, slide and stack.
+    // Bodies only translate: the Transform's rotation is left to the game. Colliders without a body act as
+    // infinitely heavy to bodies (and are not pushed by them), static colliders included.
+    // Bodies that rest long enough fall asleep with everything they rest on; touching them wakes them again.
+    class RigidBody : public Component {
+    public:
+        // A mass of 0 makes the body kinematic: it moves with its velocity, ignores gravity and pushes dynamic
+        // bodies without being pushed back. The collider must stay non-static.
+        RigidBody(Entity& e, CollisionSystem& system, Collider& collider, float mass = 1.0f);
+        ~RigidBody() override;
+
+        [[nodiscard]] Collider* collider() const { return collider_; }
+
+        [[nodiscard]] Vector2 velocity() const { return velocity_; }
+        void setVelocity(Vector2 velocity);
+        // Changes the velocity by impulse / mass; kinematic bodies ignore it.
+        void applyImpulse(Vector2 impulse);
+        // Acts until the end of the next update that moves bodies.
+        void applyForce(Vector2 force);
+
+        [[nodiscard]] float mass() const { return mass_; }
+        void setMass(float mass);
+        [[nodiscard]] bool isKinematic() const { return mass_ <= 0.0f; }
+
+        // Bounciness from 0 (none) to 1; the bouncier body of a contact wins.
+        [[nodiscard]] float restitution() const { return restitution_; }
+        void setRestitution(const float restitution) { restitution_ = restitution; }
+        // Coulomb friction coefficient; a contact uses the geometric mean of both sides.
+        [[nodiscard]] float friction() const { return friction_; }
+        void setFriction(const float friction) { friction_ = friction; }
+        [[nodiscard]] float gravityScale() const { return gravityScale_; }
+        void setGravityScale(const float scale) { gravityScale_ = scale; }
+        // Fraction of the velocity lost per second, roughly; air drag for top-down games.
+        [[nodiscard]] float damping() const { return damping_; }
+        void setDamping(const float damping) { damping_ = damping; }
+
+        [[nodiscard]] bool sleeping() const { return sleeping_; }
+        void wake();
+
+    private:
+        friend class CollisionSystem;
+
+        static constexpr std::uint32_t noState_ = ~0u;
+
+        CollisionSystem& system_;
+        Collider* collider_; // null once the collider is destroyed
+        Transform* transform_ = nullptr; // looked up on the first update
+        Vector2 velocity_{0.0f, 0.0f};
+        Vector2 force_{0.0f, 0.0f};
+        float mass_;
+        float restitution_ = 0.0f;
+        float friction_ = 0.4f;
+        float gravityScale_ = 1.0f;
+        float damping_ = 0.0f;
+        bool sleeping_ = false;
+        float sleepTime_ = 0.0f; // seconds spent below the sleep speed
+        std::uint32_t slot_ = 0; // position in the system's body list
+        std::uint32_t state_ = noState_; // index into the solver's bodies while an update runs
+        std::uint32_t version_ = 0; // Transform version after the solver last moved the body
+    };
+}
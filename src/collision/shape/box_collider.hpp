@@ -25,6 +25,8 @@ namespace rlge {
             Collider(e, system, type, layer, mask, trigger), local_(local) {}
 
 
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Box; }
+
         [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
             return other.collideWith(*this);
         }
@@ -34,7 +36,7 @@ namespace rlge {
         }
 
         [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override {
-            return narrow_phase::boxCircle(*this, c);
+            return narrow_phase::flipped(narrow_phase::boxCircle(*this, c));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override {
@@ -42,43 +44,36 @@ namespace rlge {
         }
 
         [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override {
-            return narrow_phase::polyBox(p, *this);
+            return narrow_phase::flipped(narrow_phase::polyBox(p, *this));
         }
 
-        [[nodiscard]] Rectangle axisAlignedWorldBounds() const override {
-            const auto worldPts = points();
-            if (worldPts.empty()) {
-                return Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
-            }
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
 
-            float minX = worldPts[0].x;
-            float minY = worldPts[0].y;
-            float maxX = worldPts[0].x;
-            float maxY = worldPts[0].y;
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override {
+            return narrow_phase::boxBoxOverlap(*this, b);
+        }
 
-            for (const auto& p : worldPts) {
-                if (p.x < minX) minX = p.x;
-                if (p.x > maxX) maxX = p.x;
-                if (p.y < minY) minY = p.y;
-                if (p.y > maxY) maxY = p.y;
-            }
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override {
+            return narrow_phase::boxCircleOverlap(*this, c);
+        }
 
-            return Rectangle{minX, minY, maxX - minX, maxY - minY};
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override {
+            return narrow_phase::boxObbOverlap(o, *this);
         }
 
-        [[nodiscard]] std::vector<Vector2> points() const override {
-            std::vector<Vector2> worldPts;
-            worldPts.reserve(4);
-
-            auto* t = entity().get<Transform>();
-            if (!t) {
-                worldPts.push_back({local_.x, local_.y});
-                worldPts.push_back({local_.x + local_.width, local_.y});
-                worldPts.push_back({local_.x + local_.width, local_.y + local_.height});
-                worldPts.push_back({local_.x, local_.y + local_.height});
-                return worldPts;
-            }
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override {
+            return narrow_phase::polyBoxOverlap(p, *this);
+        }
+
+        [[nodiscard]] ConvexSupport convexSupport() const override {
+            const auto& g = geometry();
+            return {g.points, 0.0f, Vector2{g.bounds.x + g.bounds.width * 0.5f, g.bounds.y + g.bounds.height * 0.5f}};
+        }
 
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override {
             const Vector2 corners[4] = {
                 {local_.x, local_.y},
                 {local_.x + local_.width, local_.y},
@@ -86,14 +81,18 @@ namespace rlge {
                 {local_.x, local_.y + local_.height}
             };
 
-            for (const auto& p : corners) {
-                const Vector2 scaled{p.x * t->scale.x, p.y * t->scale.y};
+            g.points.resize(4);
+            for (size_t i = 0; i < 4; ++i) {
+                if (!t) {
+                    g.points[i] = corners[i];
+                    continue;
+                }
+                const Vector2 scaled{corners[i].x * t->scale.x, corners[i].y * t->scale.y};
                 const Vector2 rotated = Vector2Rotate(scaled, t->rotation);
-                const Vector2 world = Vector2Add(t->position, rotated);
-                worldPts.push_back(world);
+                g.points[i] = Vector2Add(t->position, rotated);
             }
 
-            return worldPts;
+            finishPolygon(g);
         }
 
     private:
@@ -0,0 +1,13 @@
+#include "capsule_collider.hpp"
+
+namespace rlge {
+
+    CollisionManifold Collider::collideWith(const CapsuleCollider& c) const {
+        return narrow_phase::convex(c.convexSupport(), convexSupport());
+    }
+
+    bool Collider::overlapWith(const CapsuleCollider& c) const {
+        return narrow_phase::convexOverlap(c.convexSupport(), convexSupport());
+    }
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "../collider.hpp"
+#include "../narrow_phase.hpp"
+#include "box_collider.hpp"
+#include "circle_collider.hpp"
+#include "obb_collider.hpp"
+#include "polygon_collider.hpp"
+
+namespace rlge {
+    class CollisionSystem;
+    class Entity;
+
+    // Segment from start to end, inflated by radius. Collides with every shape through the GJK/EPA path.
+    class CapsuleCollider final : public Collider {
+    public:
+        CapsuleCollider(Entity& e,
+                        CollisionSystem& system,
+                        const ColliderType type,
+                        const ColliderLayerMask layer,
+                        const ColliderLayerMask mask,
+                        const Vector2& start,
+                        const Vector2& end,
+                        const float radius,
+                        const bool trigger = true) :
+            Collider(e, system, type, layer, mask, trigger), start_(start), end_(end), radius_(radius) {}
+
+        void draw() override {
+            Collider::draw();
+            if (!debugEnabled())
+                return;
+
+            // Two half circles around the segment's ends
+            const auto a = start();
+            const auto b = end();
+            const auto r = radius();
+            const auto axis = Vector2Subtract(b, a);
+            const float base = Vector2LengthSqr(axis) > 0.0f ? atan2f(axis.y, axis.x) : 0.0f;
+            std::array<Vector2, 2 * (arcSegments_ + 1)> outline{};
+            for (auto i = 0; i <= arcSegments_; ++i) {
+                const float angle = base - PI * 0.5f + PI * static_cast<float>(i) / static_cast<float>(arcSegments_);
+                const Vector2 offset{r * cosf(angle), r * sinf(angle)};
+                outline[i] = Vector2Add(b, offset);
+                outline[arcSegments_ + 1 + i] = Vector2Subtract(a, offset);
+            }
+            entity().scene().rq().submitDebugLines(outline, true, 2.0f,
+                                                   applyTriggerStyle(colorForLayer(layer()), isTrigger()));
+        }
+
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Capsule; }
+
+        [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
+            return other.collideWith(*this);
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const BoxCollider& b) const override {
+            return narrow_phase::convex(b.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override {
+            return narrow_phase::convex(c.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override {
+            return narrow_phase::convex(o.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override {
+            return narrow_phase::convex(p.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const CapsuleCollider& c) const override {
+            return narrow_phase::convex(c.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
+
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override {
+            return narrow_phase::convexOverlap(b.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override {
+            return narrow_phase::convexOverlap(c.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override {
+            return narrow_phase::convexOverlap(o.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override {
+            return narrow_phase::convexOverlap(p.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] bool overlapWith(const CapsuleCollider& c) const override {
+            return narrow_phase::convexOverlap(c.convexSupport(), convexSupport());
+        }
+
+        [[nodiscard]] ConvexSupport convexSupport() const override {
+            static_cast<void>(geometry()); // refreshes the cached world segment when the transform changed
+            return {worldSegment_, worldRadius_, Vector2Lerp(worldSegment_[0], worldSegment_[1], 0.5f)};
+        }
+
+        [[nodiscard]] Vector2 start() const {
+            static_cast<void>(geometry());
+            return worldSegment_[0];
+        }
+
+        [[nodiscard]] Vector2 end() const {
+            static_cast<void>(geometry());
+            return worldSegment_[1];
+        }
+
+        [[nodiscard]] float radius() const {
+            static_cast<void>(geometry());
+            return worldRadius_;
+        }
+
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override {
+            if (t && t->scale.x != t->scale.y) {
+                throw std::runtime_error("CapsuleCollider: scale.x != scale.y. Non-uniform scaling is not supported.");
+            }
+
+            const auto toWorld = [t](const Vector2 p) {
+                if (!t)
+                    return p;
+                return Vector2Add(t->position, Vector2Rotate(Vector2Scale(p, t->scale.x), t->rotation));
+            };
+            worldSegment_ = {toWorld(start_), toWorld(end_)};
+            worldRadius_ = t ? radius_ * t->scale.x : radius_;
+
+            // Only the segment and radius are cached; the outline is built by draw() when debug drawing is on.
+            g.points.clear();
+            g.normals.clear();
+            g.convex.count = 0;
+
+            const float minX = std::min(worldSegment_[0].x, worldSegment_[1].x) - worldRadius_;
+            const float minY = std::min(worldSegment_[0].y, worldSegment_[1].y) - worldRadius_;
+            const float maxX = std::max(worldSegment_[0].x, worldSegment_[1].x) + worldRadius_;
+            const float maxY = std::max(worldSegment_[0].y, worldSegment_[1].y) + worldRadius_;
+            g.bounds = Rectangle{minX, minY, maxX - minX, maxY - minY};
+        }
+
+    private:
+        static constexpr int arcSegments_ = 8;
+
+        Vector2 start_;
+        Vector2 end_;
+        float radius_;
+        mutable std::array<Vector2, 2> worldSegment_{};
+        mutable float worldRadius_ = 0.0f;
+    };
+}
@@ -0,0 +1,307 @@
+#include "circle_batch_collider.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <span>
+
+#include "box_collider.hpp"
+#include "capsule_collider.hpp"
+#include "circle_collider.hpp"
+#include "compound_collider.hpp"
+#include "obb_collider.hpp"
+#include "polygon_collider.hpp"
+#include "tile_grid_collider.hpp"
+#include "raymath.h"
+
+namespace rlge {
+
+    namespace {
+        // A batch spread far apart gets coarser cells rather than a huge grid.
+        constexpr int maxCellsPerAxis = 256;
+
+        CollisionManifold contact(const bool touching) {
+            CollisionManifold m;
+            m.colliding = touching;
+            return m;
+        }
+    }
+
+    CollisionManifold Collider::collideWith(const CircleBatchCollider& b) const { return contact(b.touches(*this)); }
+
+    bool Collider::overlapWith(const CircleBatchCollider& b) const { return b.touches(*this); }
+
+    CollisionManifold CircleBatchCollider::collideWith(const BoxCollider& b) const { return contact(touches(b)); }
+    CollisionManifold CircleBatchCollider::collideWith(const CircleCollider& c) const { return contact(touches(c)); }
+    CollisionManifold CircleBatchCollider::collideWith(const ObbCollider& o) const { return contact(touches(o)); }
+    CollisionManifold CircleBatchCollider::collideWith(const PolygonCollider& p) const { return contact(touches(p)); }
+    CollisionManifold CircleBatchCollider::collideWith(const CapsuleCollider& c) const { return contact(touches(c)); }
+    CollisionManifold CircleBatchCollider::collideWith(const TileGridCollider& g) const { return contact(touches(g)); }
+    CollisionManifold CircleBatchCollider::collideWith(const CompoundCollider& c) const { return contact(touches(c)); }
+
+    bool CircleBatchCollider::overlapWith(const BoxCollider& b) const { return touches(b); }
+    bool CircleBatchCollider::overlapWith(const CircleCollider& c) const { return touches(c); }
+    bool CircleBatchCollider::overlapWith(const ObbCollider& o) const { return touches(o); }
+    bool CircleBatchCollider::overlapWith(const PolygonCollider& p) const { return touches(p); }
+    bool CircleBatchCollider::overlapWith(const CapsuleCollider& c) const { return touches(c); }
+    bool CircleBatchCollider::overlapWith(const TileGridCollider& g) const { return touches(g); }
+    bool CircleBatchCollider::overlapWith(const CompoundCollider& c) const { return touches(c); }
+
+    std::size_t CircleBatchCollider::add(const Vector2 center, const float radius) {
+        centers_.push_back(center);
+        radii_.push_back(radius);
+        invalidateGeometry();
+        return centers_.size() - 1;
+    }
+
+    void CircleBatchCollider::remove(const std::size_t index) {
+        if (index >= centers_.size())
+            return;
+        centers_[index] = centers_.back();
+        radii_[index] = radii_.back();
+        centers_.pop_back();
+        radii_.pop_back();
+        invalidateGeometry();
+    }
+
+    void CircleBatchCollider::clear() {
+        centers_.clear();
+        radii_.clear();
+        invalidateGeometry();
+    }
+
+    void CircleBatchCollider::reserve(const std::size_t count) {
+        centers_.reserve(count);
+        radii_.reserve(count);
+    }
+
+    void CircleBatchCollider::setCenter(const std::size_t index, const Vector2 center) {
+        centers_[index] = center;
+        invalidateGeometry();
+    }
+
+    template <typename Fn>
+    void CircleBatchCollider::forEachNear_(const Rectangle& area, Fn&& fn) const {
+        if (columns_ == 0)
+            return;
+        // A circle reaches at most maxRadius_ past the cell holding its center.
+        const float minX = area.x - maxRadius_ - grid_.x;
+        const float minY = area.y - maxRadius_ - grid_.y;
+        const float maxX = area.x + area.width + maxRadius_ - grid_.x;
+        const float maxY = area.y + area.height + maxRadius_ - grid_.y;
+        if (maxX < 0.0f || maxY < 0.0f || minX > grid_.width || minY > grid_.height)
+            return;
+
+        const auto cell = [this](const float v, const int count) {
+            return std::clamp(static_cast<int>(v / cell_), 0, count - 1);
+        };
+        const int x0 = cell(minX, columns_);
+        const int y0 = cell(minY, rows_);
+        const int x1 = cell(maxX, columns_);
+        const int y1 = cell(maxY, rows_);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                const auto c = static_cast<std::size_t>(y * columns_ + x);
+                for (auto k = cellStart_[c]; k < cellStart_[c + 1]; ++k) {
+                    if (!fn(cellItems_[k]))
+                        return;
+                }
+            }
+        }
+    }
+
+    ConvexSupport CircleBatchCollider::support_(const std::size_t index, Vector2& center) const {
+        center = Vector2Add(origin_, centers_[index]);
+        return {std::span(&center, 1), radii_[index], center};
+    }
+
+    bool CircleBatchCollider::touches_(const std::size_t index, const Collider& other, const ColliderShape shape) const {
+        const auto c = Vector2Add(origin_, centers_[index]);
+        const auto r = radii_[index];
+        switch (shape) {
+        case ColliderShape::Box: {
+            // Same comparison as narrow_phase::boxCircleOverlap
+            const auto b = other.axisAlignedWorldBounds();
+            const auto closest = Vector2Clamp(c, Vector2{b.x, b.y}, Vector2{b.x + b.width, b.y + b.height});
+            const auto diff = Vector2Subtract(c, closest);
+            return Vector2DotProduct(diff, diff) <= r * r;
+        }
+        case ColliderShape::Circle: {
+            // Same comparison as narrow_phase::circleCircleOverlap
+            const auto& circle = static_cast<const CircleCollider&>(other);
+            const auto d = Vector2Subtract(circle.center(), c);
+            const auto rSum = r + circle.radius();
+            return Vector2DotProduct(d, d) < rSum * rSum;
+        }
+        default: {
+            // Most circles near a partner miss even its bounds; skip GJK for those.
+            const auto b = other.axisAlignedWorldBounds();
+            if (c.x + r < b.x || c.y + r < b.y || c.x - r > b.x + b.width || c.y - r > b.y + b.height)
+                return false;
+            Vector2 center;
+            return other.overlaps(support_(index, center));
+        }
+        }
+    }
+
+    bool CircleBatchCollider::touches(const Collider& other) const {
+        const auto shape = other.shape();
+        if (shape == ColliderShape::CircleBatch)
+            return false;
+
+        static_cast<void>(geometry()); // refreshes the grid
+        bool hit = false;
+        forEachNear_(other.axisAlignedWorldBounds(), [&](const std::uint32_t i) {
+            hit = touches_(i, other, shape);
+            return !hit;
+        });
+        return hit;
+    }
+
+    void CircleBatchCollider::reportHits_(const Collider& other) const {
+        if (!onHit_)
+            return;
+        const auto shape = other.shape();
+        static_cast<void>(geometry());
+        hits_.clear();
+        forEachNear_(other.axisAlignedWorldBounds(), [&](const std::uint32_t i) {
+            if (touches_(i, other, shape))
+                hits_.push_back(i);
+            return true;
+        });
+
+        std::ranges::sort(hits_, std::greater{});
+        for (const auto i : hits_) {
+            onHit_(i, &other);
+        }
+    }
+
+    bool CircleBatchCollider::overlaps(const ConvexSupport& shape) const {
+        if (shape.core.empty())
+            return false;
+
+        static_cast<void>(geometry());
+        bool hit = false;
+        forEachNear_(narrow_phase::bounds(shape), [&](const std::uint32_t i) {
+            Vector2 center;
+            hit = narrow_phase::convexOverlap(shape, support_(i, center));
+            return !hit;
+        });
+        return hit;
+    }
+
+    bool CircleBatchCollider::castAgainst(const ConvexSupport& shape, const Vector2 motion, CastHit& hit) const {
+        if (shape.core.empty())
+            return false;
+
+        static_cast<void>(geometry());
+        const auto start = narrow_phase::bounds(shape);
+        const Rectangle swept{std::min(start.x, start.x + motion.x), std::min(start.y, start.y + motion.y),
+                              start.width + std::fabs(motion.x), start.height + std::fabs(motion.y)};
+
+        bool found = false;
+        forEachNear_(swept, [&](const std::uint32_t i) {
+            Vector2 center;
+            CastHit candidate;
+            if (narrow_phase::cast(shape, support_(i, center), motion, candidate) &&
+                (!found || candidate.fraction < hit.fraction)) {
+                hit = candidate;
+                found = true;
+            }
+            return true;
+        });
+        return found;
+    }
+
+    void CircleBatchCollider::rebuildGeometry(ColliderGeometry& g, const Transform* t) const {
+        origin_ = t ? t->position : Vector2{0.0f, 0.0f};
+        g.normals.clear();
+        g.convex.count = 0;
+        maxRadius_ = 0.0f;
+
+        const auto count = centers_.size();
+        if (count == 0) {
+            grid_ = Rectangle{origin_.x, origin_.y, 0.0f, 0.0f};
+            columns_ = 0;
+            rows_ = 0;
+            g.points.clear();
+            g.bounds = grid_;
+            return;
+        }
+
+        auto minCenter = centers_[0];
+        auto maxCenter = centers_[0];
+        for (std::size_t i = 0; i < count; ++i) {
+            minCenter = Vector2Min(minCenter, centers_[i]);
+            maxCenter = Vector2Max(maxCenter, centers_[i]);
+            maxRadius_ = std::max(maxRadius_, radii_[i]);
+        }
+        grid_ = Rectangle{origin_.x + minCenter.x, origin_.y + minCenter.y, maxCenter.x - minCenter.x,
+                          maxCenter.y - minCenter.y};
+
+        cell_ = std::max({cellSize_, grid_.width / maxCellsPerAxis, grid_.height / maxCellsPerAxis});
+        columns_ = std::min(static_cast<int>(grid_.width / cell_) + 1, maxCellsPerAxis);
+        rows_ = std::min(static_cast<int>(grid_.height / cell_) + 1, maxCellsPerAxis);
+
+        // Counting sort of the circles by cell: count, prefix-sum, then place. Placing advances each cell's
+        // start to the next cell's, so the starts are shifted back by one afterwards.
+        const auto cellOf = [this](const Vector2 center) {
+            const auto x = std::min(static_cast<int>((center.x - grid_.x + origin_.x) / cell_), columns_ - 1);
+            const auto y = std::min(static_cast<int>((center.y - grid_.y + origin_.y) / cell_), rows_ - 1);
+            return static_cast<std::size_t>(y * columns_ + x);
+        };
+        const auto cells = static_cast<std::size_t>(columns_ * rows_);
+        cellStart_.assign(cells + 1, 0);
+        for (const auto& center : centers_) {
+            ++cellStart_[cellOf(center) + 1];
+        }
+        for (std::size_t c = 0; c < cells; ++c) {
+            cellStart_[c + 1] += cellStart_[c];
+        }
+        cellItems_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            cellItems_[cellStart_[cellOf(centers_[i])]++] = static_cast<std::uint32_t>(i);
+        }
+        for (auto c = cells; c > 0; --c) {
+            cellStart_[c] = cellStart_[c - 1];
+        }
+        cellStart_[0] = 0;
+
+        g.bounds = Rectangle{grid_.x - maxRadius_, grid_.y - maxRadius_, grid_.width + 2.0f * maxRadius_,
+                             grid_.height + 2.0f * maxRadius_};
+        g.points = {Vector2{g.bounds.x, g.bounds.y}, Vector2{g.bounds.x + g.bounds.width, g.bounds.y},
+                    Vector2{g.bounds.x + g.bounds.width, g.bounds.y + g.bounds.height},
+                    Vector2{g.bounds.x, g.bounds.y + g.bounds.height}};
+    }
+
+    void CircleBatchCollider::draw() {
+        Collider::draw();
+        if (!debugEnabled())
+            return;
+
+        // Every circle as an octagon; points get a small one
+        static const auto unit = [] {
+            std::array<Vector2, 8> pts{};
+            for (std::size_t i = 0; i < pts.size(); ++i) {
+                const float a = 2.0f * PI * static_cast<float>(i) / static_cast<float>(pts.size());
+                pts[i] = Vector2{cosf(a), sinf(a)};
+            }
+            return pts;
+        }();
+
+        auto& rq = entity().scene().rq();
+        const auto color = applyTriggerStyle(colorForLayer(layer()), true);
+        static_cast<void>(geometry());
+        std::array<Vector2, 8> outline{};
+        for (std::size_t i = 0; i < centers_.size(); ++i) {
+            const auto c = Vector2Add(origin_, centers_[i]);
+            const auto r = std::max(radii_[i], 1.0f);
+            for (std::size_t k = 0; k < outline.size(); ++k) {
+                outline[k] = Vector2{c.x + r * unit[k].x, c.y + r * unit[k].y};
+            }
+            rq.submitDebugLines(outline, true, 1.0f, color);
+        }
+    }
+
+}
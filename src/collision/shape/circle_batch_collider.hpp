@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "raylib.h"
+#include "../collider.hpp"
+
+namespace rlge {
+    class BoxCollider;
+    class CircleCollider;
+    class ObbCollider;
+    class PolygonCollider;
+    class CapsuleCollider;
+    class TileGridCollider;
+    class CompoundCollider;
+    class CollisionSystem;
+    class Entity;
+
+    // Receives the index of a circle of the batch and the collider it touches.
+    using CircleHitCallback = std::function<void(std::size_t index, const Collider* other)>;
+
+    // Thousands of circles, or points with radius 0, as one collider: bullets and other swarms that would be too
+    // many entities otherwise. The batch enters the broad phase once, with the bounds of all its circles, and
+    // buckets the circles in a grid of its own, so a partner is only tested against the circles near it.
+    // Touching circles are reported by index through setOnHit; the collider callbacks see the batch as a whole.
+    // Always a trigger. Circles are relative to the Transform's position; rotation and scale are ignored.
+    class CircleBatchCollider final : public Collider {
+    public:
+        // cellSize is the edge of the batch's grid cells; a few times the circles' size works best.
+        CircleBatchCollider(Entity& e,
+                            CollisionSystem& system,
+                            const ColliderType type,
+                            const ColliderLayerMask layer,
+                            const ColliderLayerMask mask,
+                            const float cellSize = 32.0f) :
+            Collider(e, system, type, layer, mask, true), cellSize_(cellSize) {}
+
+        void draw() override;
+
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::CircleBatch; }
+
+        [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
+            return other.collideWith(*this);
+        }
+
+        // Triggers are never pushed, so the manifolds only say whether any circle touches.
+        [[nodiscard]] CollisionManifold collideWith(const BoxCollider& b) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override;
+        [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const TileGridCollider& g) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CircleBatchCollider&) const override { return {}; }
+        [[nodiscard]] CollisionManifold collideWith(const CompoundCollider& c) const override;
+
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
+
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override;
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override;
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override;
+        [[nodiscard]] bool overlapWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const TileGridCollider& g) const override;
+        [[nodiscard]] bool overlapWith(const CircleBatchCollider&) const override { return false; }
+        [[nodiscard]] bool overlapWith(const CompoundCollider& c) const override;
+
+        // The batch is not one convex shape; queries and the narrow phase go through the circles instead.
+        [[nodiscard]] ConvexSupport convexSupport() const override { return {}; }
+
+        [[nodiscard]] bool overlaps(const ConvexSupport& shape) const override;
+        [[nodiscard]] bool castAgainst(const ConvexSupport& shape, Vector2 motion, CastHit& hit) const override;
+
+        // Whether any circle touches `other`.
+        [[nodiscard]] bool touches(const Collider& other) const;
+
+        // Returns the new circle's index.
+        std::size_t add(Vector2 center, float radius = 0.0f);
+        // The last circle takes the removed one's index.
+        void remove(std::size_t index);
+        void clear();
+        void reserve(std::size_t count);
+        void setCenter(std::size_t index, Vector2 center);
+
+        [[nodiscard]] std::size_t size() const { return centers_.size(); }
+        [[nodiscard]] Vector2 center(const std::size_t index) const { return centers_[index]; }
+        [[nodiscard]] float radius(const std::size_t index) const { return radii_[index]; }
+
+        // Called once per touching circle and partner on every update they touch, highest index first: removing
+        // the reported circle from the callback never moves one that is still to be reported.
+        void setOnHit(CircleHitCallback cb) { onHit_ = std::move(cb); }
+
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override;
+
+    private:
+        friend class CollisionSystem;
+
+        // Visits the circles whose cells the rectangle, grown by the largest radius, covers; stops when fn
+        // returns false.
+        template <typename Fn>
+        void forEachNear_(const Rectangle& area, Fn&& fn) const;
+        [[nodiscard]] bool touches_(std::size_t index, const Collider& other, ColliderShape shape) const;
+        [[nodiscard]] ConvexSupport support_(std::size_t index, Vector2& center) const;
+        void reportHits_(const Collider& other) const;
+
+        float cellSize_;
+        std::vector<Vector2> centers_;
+        std::vector<float> radii_;
+        CircleHitCallback onHit_;
+
+        // Grid of the circle centers, rebuilt with the geometry: the circles of cell c are
+        // cellItems_[cellStart_[c], cellStart_[c + 1]).
+        mutable Vector2 origin_{0.0f, 0.0f};
+        mutable Rectangle grid_{0.0f, 0.0f, 0.0f, 0.0f};
+        mutable float cell_ = 0.0f;
+        mutable int columns_ = 0;
+        mutable int rows_ = 0;
+        mutable float maxRadius_ = 0.0f;
+        mutable std::vector<std::uint32_t> cellStart_;
+        mutable std::vector<std::uint32_t> cellItems_;
+        mutable std::vector<std::uint32_t> hits_; // reportHits_ scratch
+    };
+}
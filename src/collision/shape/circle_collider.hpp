@@ -1,7 +1,10 @@
 #pragma once
+#include <array>
+#include <cmath>
 #include <stdexcept>
 
 #include "raylib.h"
+#include "raymath.h"
 #include "../collider.hpp"
 #include "../narrow_phase.hpp"
 
@@ -21,6 +24,32 @@ namespace rlge {
                        const bool trigger = true) :
             Collider(e, system, type, layer, mask, trigger), center_(center), radius_(radius) {}
 
+        void draw() override {
+            Collider::draw();
+            if (!debugEnabled())
+                return;
+
+            static const auto unitCircle = [] {
+                std::array<Vector2, outlineSegments_> pts{};
+                for (auto i = 0; i < outlineSegments_; ++i) {
+                    const float a = (2.0f * PI * static_cast<float>(i)) / static_cast<float>(outlineSegments_);
+                    pts[i] = Vector2{cosf(a), sinf(a)};
+                }
+                return pts;
+            }();
+
+            const auto c = center();
+            const auto r = radius();
+            std::array<Vector2, outlineSegments_> outline{};
+            for (auto i = 0; i < outlineSegments_; ++i) {
+                outline[i] = Vector2{c.x + r * unitCircle[i].x, c.y + r * unitCircle[i].y};
+            }
+            entity().scene().rq().submitDebugLines(outline, true, 2.0f,
+                                                   applyTriggerStyle(colorForLayer(layer()), isTrigger()));
+        }
+
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Circle; }
+
         [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
             return other.collideWith(*this);
         }
@@ -30,7 +59,7 @@ namespace rlge {
         }
 
         [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override {
-            return narrow_phase::circleCircle(*this, c);
+            return narrow_phase::flipped(narrow_phase::circleCircle(*this, c));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override {
@@ -41,48 +70,63 @@ namespace rlge {
             return narrow_phase::polyCircle(p, *this);
         }
 
-        [[nodiscard]] Rectangle axisAlignedWorldBounds() const override {
-            auto const t = entity().get<Transform>();
-            const auto x = t->position.x + center_.x;
-            const auto y = t->position.y + center_.y;
-            return {x - radius_, y - radius_, radius_ * 2, radius_ * 2};
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
         }
 
-        [[nodiscard]] Vector2 center() const {
-            auto* t = entity().get<Transform>();
-            return t ? t->position + center_ : center_;
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override {
+            return narrow_phase::boxCircleOverlap(b, *this);
         }
 
-        [[nodiscard]] float radius() const {
-            auto* t = entity().get<Transform>();
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override {
+            return narrow_phase::circleCircleOverlap(*this, c);
+        }
 
-            if (t && t->scale.x != t->scale.y) {
-                throw std::runtime_error("CircleCollider: scale.x != scale.y. Ellipses are not supported.");
-            }
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override {
+            return narrow_phase::obbCircleOverlap(o, *this);
+        }
 
-            return t ? radius_ * t->scale.x : radius_;
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override {
+            return narrow_phase::polyCircleOverlap(p, *this);
         }
 
-        [[nodiscard]] std::vector<Vector2> points() const override {
-            const auto worldCenter = center();
-            const auto worldRadius = radius();
+        [[nodiscard]] Vector2 center() const {
+            static_cast<void>(geometry()); // refreshes the cached world center when the transform changed
+            return worldCenter_;
+        }
+
+        [[nodiscard]] float radius() const {
+            static_cast<void>(geometry());
+            return worldRadius_;
+        }
 
-            constexpr auto segments = 32;
-            std::vector<Vector2> pts;
-            pts.reserve(segments);
+        [[nodiscard]] ConvexSupport convexSupport() const override {
+            static_cast<void>(geometry());
+            return {std::span(&worldCenter_, 1), worldRadius_, worldCenter_};
+        }
 
-            for (auto i = 0; i < segments; ++i) {
-                const float t = (2.0f * PI * static_cast<float>(i)) / static_cast<float>(segments);
-                const float cs = cosf(t);
-                const float sn = sinf(t);
-                pts.emplace_back(worldCenter.x + worldRadius * cs, worldCenter.y + worldRadius * sn);
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override {
+            if (t && t->scale.x != t->scale.y) {
+                throw std::runtime_error("CircleCollider: scale.x != scale.y. Ellipses are not supported.");
             }
 
-            return pts;
+            worldCenter_ = t ? t->position + center_ : center_;
+            worldRadius_ = t ? radius_ * t->scale.x : radius_;
+
+            // Only the center and radius are cached; the outline is built by draw() when debug drawing is on.
+            g.points.clear();
+            g.normals.clear();
+            g.bounds = Rectangle{worldCenter_.x - worldRadius_, worldCenter_.y - worldRadius_,
+                                 worldRadius_ * 2, worldRadius_ * 2};
         }
 
     private:
+        static constexpr int outlineSegments_ = 32;
+
         Vector2 center_;
         float radius_;
+        mutable Vector2 worldCenter_{0.0f, 0.0f};
+        mutable float worldRadius_ = 0.0f;
     };
 }
@@ -0,0 +1,303 @@
+#include "compound_collider.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+
+#include "box_collider.hpp"
+#include "capsule_collider.hpp"
+#include "circle_batch_collider.hpp"
+#include "circle_collider.hpp"
+#include "obb_collider.hpp"
+#include "polygon_collider.hpp"
+#include "tile_grid_collider.hpp"
+#include "raymath.h"
+
+namespace rlge {
+
+    CollisionManifold Collider::collideWith(const CompoundCollider& c) const { return c.collide(*this); }
+
+    bool Collider::overlapWith(const CompoundCollider& c) const { return c.overlap(*this); }
+
+    CollisionManifold CompoundCollider::collideWith(const BoxCollider& b) const {
+        return narrow_phase::flipped(collide(b));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const CircleCollider& c) const {
+        return narrow_phase::flipped(collide(c));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const ObbCollider& o) const {
+        return narrow_phase::flipped(collide(o));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const PolygonCollider& p) const {
+        return narrow_phase::flipped(collide(p));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const CapsuleCollider& c) const {
+        return narrow_phase::flipped(collide(c));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const TileGridCollider& g) const {
+        return narrow_phase::flipped(collide(g));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const CircleBatchCollider& b) const {
+        return narrow_phase::flipped(collide(b));
+    }
+
+    CollisionManifold CompoundCollider::collideWith(const CompoundCollider& c) const {
+        return narrow_phase::flipped(collide(c));
+    }
+
+    bool CompoundCollider::overlapWith(const BoxCollider& b) const { return overlap(b); }
+    bool CompoundCollider::overlapWith(const CircleCollider& c) const { return overlap(c); }
+    bool CompoundCollider::overlapWith(const ObbCollider& o) const { return overlap(o); }
+    bool CompoundCollider::overlapWith(const PolygonCollider& p) const { return overlap(p); }
+    bool CompoundCollider::overlapWith(const CapsuleCollider& c) const { return overlap(c); }
+    bool CompoundCollider::overlapWith(const TileGridCollider& g) const { return overlap(g); }
+    bool CompoundCollider::overlapWith(const CircleBatchCollider& b) const { return overlap(b); }
+    bool CompoundCollider::overlapWith(const CompoundCollider& c) const { return overlap(c); }
+
+    std::size_t CompoundCollider::addChild_(const std::size_t count, const float radius) {
+        children_.push_back(Child{static_cast<std::uint32_t>(localPoints_.size() - count),
+                                  static_cast<std::uint32_t>(count), radius});
+        invalidateGeometry();
+        return children_.size() - 1;
+    }
+
+    std::size_t CompoundCollider::addBox(const Rectangle& rect) {
+        localPoints_.insert(localPoints_.end(), {Vector2{rect.x, rect.y}, Vector2{rect.x + rect.width, rect.y},
+                                                 Vector2{rect.x + rect.width, rect.y + rect.height},
+                                                 Vector2{rect.x, rect.y + rect.height}});
+        return addChild_(4, 0.0f);
+    }
+
+    std::size_t CompoundCollider::addCircle(const Vector2 center, const float radius) {
+        localPoints_.push_back(center);
+        return addChild_(1, radius);
+    }
+
+    std::size_t CompoundCollider::addPolygon(const std::vector<Vector2>& points) {
+        localPoints_.insert(localPoints_.end(), points.begin(), points.end());
+        return addChild_(points.size(), 0.0f);
+    }
+
+    std::size_t CompoundCollider::addCapsule(const Vector2 start, const Vector2 end, const float radius) {
+        localPoints_.insert(localPoints_.end(), {start, end});
+        return addChild_(2, radius);
+    }
+
+    Rectangle CompoundCollider::childBounds(const std::size_t index) const {
+        static_cast<void>(geometry());
+        return childBounds_[index];
+    }
+
+    ConvexSupport CompoundCollider::support_(const std::size_t index) const {
+        const auto& child = children_[index];
+        return {std::span(worldPoints_).subspan(child.first, child.count), child.radius * scale_,
+                childCenters_[index]};
+    }
+
+    template <typename Fn>
+    void CompoundCollider::forEachNear_(const Rectangle& bounds, Fn&& fn) const {
+        static_cast<void>(geometry());
+        for (std::size_t i = 0; i < children_.size(); ++i) {
+            if (children_[i].count == 0 || !CheckCollisionRecs(childBounds_[i], bounds))
+                continue;
+            if (!fn(i, support_(i)))
+                return;
+        }
+    }
+
+    CollisionManifold CompoundCollider::collide(const Collider& other) const {
+        CollisionManifold deepest{};
+        const auto keep = [&deepest](const CollisionManifold& m) {
+            if (m.colliding && (!deepest.colliding || m.depth > deepest.depth))
+                deepest = m;
+        };
+
+        switch (other.shape()) {
+        case ColliderShape::TileGrid: {
+            const auto& grid = static_cast<const TileGridCollider&>(other);
+            forEachNear_(other.axisAlignedWorldBounds(), [&](std::size_t, const ConvexSupport& child) {
+                keep(grid.collide(child));
+                return true;
+            });
+            return deepest;
+        }
+        case ColliderShape::CircleBatch: {
+            CollisionManifold m;
+            m.colliding = static_cast<const CircleBatchCollider&>(other).touches(*this);
+            return m;
+        }
+        case ColliderShape::Compound: {
+            const auto& compound = static_cast<const CompoundCollider&>(other);
+            forEachNear_(other.axisAlignedWorldBounds(), [&](const std::size_t i, const ConvexSupport& child) {
+                compound.forEachNear_(childBounds_[i], [&](std::size_t, const ConvexSupport& theirs) {
+                    keep(narrow_phase::convex(child, theirs));
+                    return true;
+                });
+                return true;
+            });
+            return deepest;
+        }
+        default: {
+            const auto theirs = other.convexSupport();
+            if (theirs.core.empty())
+                return deepest;
+            forEachNear_(other.axisAlignedWorldBounds(), [&](std::size_t, const ConvexSupport& child) {
+                keep(narrow_phase::convex(child, theirs));
+                return true;
+            });
+            return deepest;
+        }
+        }
+    }
+
+    bool CompoundCollider::overlap(const Collider& other) const {
+        if (other.shape() == ColliderShape::CircleBatch)
+            return static_cast<const CircleBatchCollider&>(other).touches(*this);
+        return touchingChild(other) != noChild;
+    }
+
+    std::size_t CompoundCollider::touchingChild(const Collider& other) const {
+        const auto shape = other.shape();
+        const auto theirs = other.convexSupport();
+        std::size_t found = noChild;
+        forEachNear_(other.axisAlignedWorldBounds(), [&](const std::size_t i, const ConvexSupport& child) {
+            // Shapes made of pieces answer for a support-mapped shape themselves
+            const bool touching = shape == ColliderShape::TileGrid || shape == ColliderShape::CircleBatch ||
+                                          shape == ColliderShape::Compound
+                                      ? other.overlaps(child)
+                                      : !theirs.core.empty() && narrow_phase::convexOverlap(child, theirs);
+            if (touching)
+                found = i;
+            return !touching;
+        });
+        return found;
+    }
+
+    bool CompoundCollider::overlaps(const ConvexSupport& shape) const {
+        if (shape.core.empty())
+            return false;
+
+        bool hit = false;
+        forEachNear_(narrow_phase::bounds(shape), [&](std::size_t, const ConvexSupport& child) {
+            hit = narrow_phase::convexOverlap(shape, child);
+            return !hit;
+        });
+        return hit;
+    }
+
+    bool CompoundCollider::castAgainst(const ConvexSupport& shape, const Vector2 motion, CastHit& hit) const {
+        if (shape.core.empty())
+            return false;
+
+        const auto start = narrow_phase::bounds(shape);
+        const Rectangle swept{std::min(start.x, start.x + motion.x), std::min(start.y, start.y + motion.y),
+                              start.width + std::fabs(motion.x), start.height + std::fabs(motion.y)};
+
+        bool found = false;
+        forEachNear_(swept, [&](std::size_t, const ConvexSupport& child) {
+            CastHit candidate;
+            if (narrow_phase::cast(shape, child, motion, candidate) && (!found || candidate.fraction < hit.fraction)) {
+                hit = candidate;
+                found = true;
+            }
+            return true;
+        });
+        return found;
+    }
+
+    void CompoundCollider::rebuildGeometry(ColliderGeometry& g, const Transform* t) const {
+        if (t && t->scale.x != t->scale.y) {
+            throw std::runtime_error("CompoundCollider: scale.x != scale.y. Non-uniform scaling is not supported.");
+        }
+
+        scale_ = t ? t->scale.x : 1.0f;
+        worldPoints_.resize(localPoints_.size());
+        for (std::size_t i = 0; i < localPoints_.size(); ++i) {
+            const auto p = localPoints_[i];
+            worldPoints_[i] = t ? Vector2Add(t->position, Vector2Rotate(Vector2Scale(p, scale_), t->rotation)) : p;
+        }
+
+        childBounds_.resize(children_.size());
+        childCenters_.resize(children_.size());
+        Rectangle bounds{0.0f, 0.0f, 0.0f, 0.0f};
+        bool any = false;
+        for (std::size_t i = 0; i < children_.size(); ++i) {
+            const auto& child = children_[i];
+            if (child.count == 0) {
+                childBounds_[i] = Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
+                childCenters_[i] = Vector2{0.0f, 0.0f};
+                continue;
+            }
+            const auto support = std::span(worldPoints_).subspan(child.first, child.count);
+            Vector2 sum{0.0f, 0.0f};
+            for (const auto& p : support) {
+                sum = Vector2Add(sum, p);
+            }
+            childCenters_[i] = Vector2Scale(sum, 1.0f / static_cast<float>(child.count));
+            childBounds_[i] = narrow_phase::bounds(ConvexSupport{support, child.radius * scale_, childCenters_[i]});
+
+            const auto& b = childBounds_[i];
+            if (!any) {
+                bounds = b;
+                any = true;
+                continue;
+            }
+            const float minX = std::min(bounds.x, b.x);
+            const float minY = std::min(bounds.y, b.y);
+            const float maxX = std::max(bounds.x + bounds.width, b.x + b.width);
+            const float maxY = std::max(bounds.y + bounds.height, b.y + b.height);
+            bounds = Rectangle{minX, minY, maxX - minX, maxY - minY};
+        }
+
+        if (!any && t)
+            bounds = Rectangle{t->position.x, t->position.y, 0.0f, 0.0f};
+        g.points.clear();
+        g.normals.clear();
+        g.convex.count = 0;
+        g.bounds = bounds;
+    }
+
+    void CompoundCollider::draw() {
+        Collider::draw();
+        if (!debugEnabled())
+            return;
+
+        // Polygons as they are, rounded children as the outline of their core grown by the radius
+        static constexpr std::size_t arcSegments = 16;
+        auto& rq = entity().scene().rq();
+        const auto color = applyTriggerStyle(colorForLayer(layer()), isTrigger());
+        static_cast<void>(geometry());
+        std::vector<Vector2> outline;
+        for (std::size_t i = 0; i < children_.size(); ++i) {
+            const auto support = support_(i);
+            if (support.radius <= 0.0f) {
+                rq.submitDebugLines(support.core, true, 2.0f, color);
+                continue;
+            }
+            // Circle or capsule: half circles around each end of the core
+            const auto a = support.core.front();
+            const auto b = support.core.back();
+            const auto axis = Vector2Subtract(b, a);
+            const float base = Vector2LengthSqr(axis) > 0.0f ? atan2f(axis.y, axis.x) : 0.0f;
+            outline.clear();
+            for (std::size_t k = 0; k <= arcSegments; ++k) {
+                const float angle = base - PI * 0.5f + PI * static_cast<float>(k) / static_cast<float>(arcSegments);
+                outline.push_back(Vector2Add(b, Vector2{support.radius * cosf(angle), support.radius * sinf(angle)}));
+            }
+            for (std::size_t k = 0; k <= arcSegments; ++k) {
+                const float angle = base + PI * 0.5f + PI * static_cast<float>(k) / static_cast<float>(arcSegments);
+                outline.push_back(Vector2Add(a, Vector2{support.radius * cosf(angle), support.radius * sinf(angle)}));
+            }
+            rq.submitDebugLines(outline, true, 2.0f, color);
+        }
+    }
+
+}
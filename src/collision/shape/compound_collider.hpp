@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "raylib.h"
+#include "../collider.hpp"
+
+namespace rlge {
+    class BoxCollider;
+    class CircleCollider;
+    class ObbCollider;
+    class PolygonCollider;
+    class CapsuleCollider;
+    class TileGridCollider;
+    class CircleBatchCollider;
+    class CollisionSystem;
+    class Entity;
+
+    // Several convex shapes in the entity's local space as one collider, e.g. a body box and a head circle.
+    // The compound enters the broad phase once, with the bounds of all its children; the narrow phase then only
+    // tests the children whose bounds reach the partner, and the deepest child contact becomes the manifold.
+    // Children are never tested against each other.
+    class CompoundCollider final : public Collider {
+    public:
+        static constexpr std::size_t noChild = ~std::size_t{0};
+
+        CompoundCollider(Entity& e,
+                         CollisionSystem& system,
+                         const ColliderType type,
+                         const ColliderLayerMask layer,
+                         const ColliderLayerMask mask,
+                         const bool trigger = true) :
+            Collider(e, system, type, layer, mask, trigger) {}
+
+        void draw() override;
+
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Compound; }
+
+        [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
+            return other.collideWith(*this);
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const BoxCollider& b) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override;
+        [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const TileGridCollider& g) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CircleBatchCollider& b) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CompoundCollider& c) const override;
+
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
+
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override;
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override;
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override;
+        [[nodiscard]] bool overlapWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const TileGridCollider& g) const override;
+        [[nodiscard]] bool overlapWith(const CircleBatchCollider& b) const override;
+        [[nodiscard]] bool overlapWith(const CompoundCollider& c) const override;
+
+        // The compound is not one convex shape; queries and the narrow phase go through the children instead.
+        [[nodiscard]] ConvexSupport convexSupport() const override { return {}; }
+
+        [[nodiscard]] bool overlaps(const ConvexSupport& shape) const override;
+        [[nodiscard]] bool castAgainst(const ConvexSupport& shape, Vector2 motion, CastHit& hit) const override;
+
+        // Deepest child contact with `other`, normal pointing from the compound to other.
+        [[nodiscard]] CollisionManifold collide(const Collider& other) const;
+        [[nodiscard]] bool overlap(const Collider& other) const;
+
+        // Each returns the new child's index. Polygons must be convex.
+        std::size_t addBox(const Rectangle& rect);
+        std::size_t addCircle(Vector2 center, float radius);
+        std::size_t addPolygon(const std::vector<Vector2>& points);
+        std::size_t addCapsule(Vector2 start, Vector2 end, float radius);
+
+        [[nodiscard]] std::size_t childCount() const { return children_.size(); }
+        [[nodiscard]] Rectangle childBounds(std::size_t index) const;
+        // Lowest index of a child touching `other`, or noChild; e.g. to tell a head hit from a body hit.
+        [[nodiscard]] std::size_t touchingChild(const Collider& other) const;
+
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override;
+
+    private:
+        struct Child {
+            std::uint32_t first; // into localPoints_ and worldPoints_
+            std::uint32_t count;
+            float radius;
+        };
+
+        std::size_t addChild_(std::size_t count, float radius);
+        [[nodiscard]] ConvexSupport support_(std::size_t index) const;
+        // Calls fn(child, support) for every child whose bounds overlap `bounds`; stops when fn returns false.
+        template <typename Fn>
+        void forEachNear_(const Rectangle& bounds, Fn&& fn) const;
+
+        std::vector<Child> children_;
+        std::vector<Vector2> localPoints_;
+        mutable std::vector<Vector2> worldPoints_;
+        mutable std::vector<Rectangle> childBounds_;
+        mutable std::vector<Vector2> childCenters_;
+        mutable float scale_ = 1.0f;
+    };
+}
@@ -29,60 +29,55 @@ namespace rlge {
             , halfSize_(halfSize)
             , rotation_(rotation) {}
 
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Obb; }
+
         [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
             return other.collideWith(*this);
         }
 
         [[nodiscard]] CollisionManifold collideWith(const BoxCollider& b) const override {
-            return narrow_phase::boxObb(*this, b);
+            return narrow_phase::flipped(narrow_phase::boxObb(*this, b));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override {
-            return narrow_phase::obbCircle(*this, c);
+            return narrow_phase::flipped(narrow_phase::obbCircle(*this, c));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override {
-            return narrow_phase::obbPolygon(*this, p);
+            return narrow_phase::flipped(narrow_phase::obbPolygon(*this, p));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override {
-            return narrow_phase::obbObb(*this, o);
+            return narrow_phase::flipped(narrow_phase::obbObb(*this, o));
         }
 
-        [[nodiscard]] Rectangle axisAlignedWorldBounds() const override {
-            const auto worldPts = points();
-            if (worldPts.empty()) {
-                return Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
-            }
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
 
-            float minX = worldPts[0].x;
-            float minY = worldPts[0].y;
-            float maxX = worldPts[0].x;
-            float maxY = worldPts[0].y;
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override {
+            return narrow_phase::boxObbOverlap(*this, b);
+        }
 
-            for (const auto& p : worldPts) {
-                if (p.x < minX) minX = p.x;
-                if (p.x > maxX) maxX = p.x;
-                if (p.y < minY) minY = p.y;
-                if (p.y > maxY) maxY = p.y;
-            }
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override {
+            return narrow_phase::obbCircleOverlap(*this, c);
+        }
 
-            return Rectangle{minX, minY, maxX - minX, maxY - minY};
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override {
+            return narrow_phase::obbPolygonOverlap(*this, p);
         }
 
-        [[nodiscard]] std::vector<Vector2> points() const override {
-            std::vector<Vector2> worldPts;
-            worldPts.reserve(4);
-
-            auto* t = entity().get<Transform>();
-            if (!t) {
-                worldPts.push_back(Vector2Add(center_, {-halfSize_.x, -halfSize_.y}));
-                worldPts.push_back(Vector2Add(center_, { halfSize_.x, -halfSize_.y}));
-                worldPts.push_back(Vector2Add(center_, { halfSize_.x,  halfSize_.y}));
-                worldPts.push_back(Vector2Add(center_, {-halfSize_.x,  halfSize_.y}));
-                return worldPts;
-            }
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override {
+            return narrow_phase::obbObbOverlap(*this, o);
+        }
 
+        [[nodiscard]] ConvexSupport convexSupport() const override {
+            const auto& g = geometry();
+            return {g.points, 0.0f, Vector2{g.bounds.x + g.bounds.width * 0.5f, g.bounds.y + g.bounds.height * 0.5f}};
+        }
+
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override {
             const Vector2 localCorners[4] = {
                 {-halfSize_.x, -halfSize_.y},
                 { halfSize_.x, -halfSize_.y},
@@ -90,19 +85,24 @@ namespace rlge {
                 {-halfSize_.x,  halfSize_.y}
             };
 
-            for (const auto& c : localCorners) {
+            g.points.resize(4);
+            for (size_t i = 0; i < 4; ++i) {
+                if (!t) {
+                    g.points[i] = Vector2Add(center_, localCorners[i]);
+                    continue;
+                }
+
                 // Apply local OBB rotation around its center
-                const Vector2 rotatedLocal = Vector2Rotate(c, rotation_);
+                const Vector2 rotatedLocal = Vector2Rotate(localCorners[i], rotation_);
                 const Vector2 localPoint = Vector2Add(center_, rotatedLocal);
 
                 // Then apply entity scale, rotation, translation (same order as PolygonCollider / BoxCollider)
                 const Vector2 scaled{localPoint.x * t->scale.x, localPoint.y * t->scale.y};
                 const Vector2 rotatedWorld = Vector2Rotate(scaled, t->rotation);
-                const Vector2 world = Vector2Add(t->position, rotatedWorld);
-                worldPts.push_back(world);
+                g.points[i] = Vector2Add(t->position, rotatedWorld);
             }
 
-            return worldPts;
+            finishPolygon(g);
         }
 
     private:
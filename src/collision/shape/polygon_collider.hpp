@@ -27,6 +27,8 @@ namespace rlge {
             : Collider(e, system, type, layer, mask, trigger)
             , localPoints_(std::move(localPoints)) {}
 
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::Polygon; }
+
         [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
             return other.collideWith(*this);
         }
@@ -36,7 +38,7 @@ namespace rlge {
         }
 
         [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override {
-            return narrow_phase::polyCircle(*this, c);
+            return narrow_phase::flipped(narrow_phase::polyCircle(*this, c));
         }
 
         [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override {
@@ -44,47 +46,49 @@ namespace rlge {
         }
 
         [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override {
-            return narrow_phase::polyPoly(*this, p);
+            return narrow_phase::flipped(narrow_phase::polyPoly(*this, p));
         }
 
-        [[nodiscard]] Rectangle axisAlignedWorldBounds() const override {
-            const auto worldPts = points();
-            if (worldPts.empty()) {
-                return Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
-            }
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
 
-            float minX = worldPts[0].x;
-            float minY = worldPts[0].y;
-            float maxX = worldPts[0].x;
-            float maxY = worldPts[0].y;
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override {
+            return narrow_phase::polyBoxOverlap(*this, b);
+        }
 
-            for (const auto& p : worldPts) {
-                if (p.x < minX) minX = p.x;
-                if (p.x > maxX) maxX = p.x;
-                if (p.y < minY) minY = p.y;
-                if (p.y > maxY) maxY = p.y;
-            }
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override {
+            return narrow_phase::polyCircleOverlap(*this, c);
+        }
 
-            return Rectangle{minX, minY, maxX - minX, maxY - minY};
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override {
+            return narrow_phase::obbPolygonOverlap(o, *this);
         }
 
-        [[nodiscard]] std::vector<Vector2> points() const override {
-            std::vector<Vector2> worldPts;
-            worldPts.reserve(localPoints_.size());
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override {
+            return narrow_phase::polyPolyOverlap(*this, p);
+        }
 
-            auto* t = entity().get<Transform>();
-            if (!t) {
-                return localPoints_;
-            }
+        [[nodiscard]] ConvexSupport convexSupport() const override {
+            const auto& g = geometry();
+            return {g.points, 0.0f, Vector2{g.bounds.x + g.bounds.width * 0.5f, g.bounds.y + g.bounds.height * 0.5f}};
+        }
 
-            for (const auto& p : localPoints_) {
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override {
+            g.points.resize(localPoints_.size());
+            for (size_t i = 0; i < localPoints_.size(); ++i) {
+                const auto& p = localPoints_[i];
+                if (!t) {
+                    g.points[i] = p;
+                    continue;
+                }
                 const Vector2 scaled{p.x * t->scale.x, p.y * t->scale.y};
                 const Vector2 rotated = Vector2Rotate(scaled, t->rotation);
-                const Vector2 world = Vector2Add(t->position, rotated);
-                worldPts.push_back(world);
+                g.points[i] = Vector2Add(t->position, rotated);
             }
 
-            return worldPts;
+            finishPolygon(g);
         }
 
     private:
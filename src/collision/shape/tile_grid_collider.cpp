@@ -0,0 +1,264 @@
+#include "tile_grid_collider.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "box_collider.hpp"
+#include "capsule_collider.hpp"
+#include "circle_collider.hpp"
+#include "obb_collider.hpp"
+#include "polygon_collider.hpp"
+#include "raymath.h"
+
+namespace rlge {
+
+    namespace {
+        // Push directions with a smaller component than this are treated as axis-aligned.
+        constexpr float axisTolerance = 1e-4f;
+
+        struct TileShape {
+            std::array<Vector2, 4> corners;
+            Vector2 center;
+
+            explicit TileShape(const Rectangle& r) :
+                corners{Vector2{r.x, r.y}, Vector2{r.x + r.width, r.y}, Vector2{r.x + r.width, r.y + r.height},
+                        Vector2{r.x, r.y + r.height}}
+                , center{r.x + r.width * 0.5f, r.y + r.height * 0.5f} {}
+
+            [[nodiscard]] ConvexSupport support() const { return {corners, 0.0f, center}; }
+        };
+
+        // Smallest projection of the shape onto the axis
+        float minProjection(const ConvexSupport& s, const Vector2 axis) {
+            float best = std::numeric_limits<float>::max();
+            for (const auto& p : s.core) {
+                best = std::min(best, Vector2DotProduct(p, axis));
+            }
+            return best - s.radius;
+        }
+    }
+
+    CollisionManifold Collider::collideWith(const TileGridCollider& g) const {
+        auto m = g.collide(*this);
+        m.normal = Vector2Negate(m.normal);
+        return m;
+    }
+
+    CollisionManifold TileGridCollider::collideWith(const BoxCollider& b) const { return collide(b); }
+    CollisionManifold TileGridCollider::collideWith(const CircleCollider& c) const { return collide(c); }
+    CollisionManifold TileGridCollider::collideWith(const ObbCollider& o) const { return collide(o); }
+    CollisionManifold TileGridCollider::collideWith(const PolygonCollider& p) const { return collide(p); }
+    CollisionManifold TileGridCollider::collideWith(const CapsuleCollider& c) const { return collide(c); }
+
+    // Any solid tile counts, including buried ones that the merged manifold leaves to their neighbours.
+    bool Collider::overlapWith(const TileGridCollider& g) const { return g.overlaps(convexSupport()); }
+
+    bool TileGridCollider::overlapWith(const BoxCollider& b) const { return overlaps(b.convexSupport()); }
+    bool TileGridCollider::overlapWith(const CircleCollider& c) const { return overlaps(c.convexSupport()); }
+    bool TileGridCollider::overlapWith(const ObbCollider& o) const { return overlaps(o.convexSupport()); }
+    bool TileGridCollider::overlapWith(const PolygonCollider& p) const { return overlaps(p.convexSupport()); }
+    bool TileGridCollider::overlapWith(const CapsuleCollider& c) const { return overlaps(c.convexSupport()); }
+
+    void TileGridCollider::setSolid(const int x, const int y, const bool solid) {
+        if (x < 0 || y < 0 || x >= columns_ || y >= rows_)
+            return;
+        solid_[y * columns_ + x] = solid ? 1 : 0;
+        invalidateGeometry();
+    }
+
+    TileGridCollider::TileRange TileGridCollider::tilesIn_(const Rectangle& bounds) const {
+        static_cast<void>(geometry()); // refreshes origin_
+        const auto cell = [](const float v, const float size, const int count) {
+            return std::clamp(static_cast<int>(std::floor(v / size)), -1, count);
+        };
+        TileRange r{cell(bounds.x - origin_.x, tileSize_.x, columns_), cell(bounds.y - origin_.y, tileSize_.y, rows_),
+                    cell(bounds.x + bounds.width - origin_.x, tileSize_.x, columns_),
+                    cell(bounds.y + bounds.height - origin_.y, tileSize_.y, rows_)};
+        r.minX = std::max(r.minX, 0);
+        r.minY = std::max(r.minY, 0);
+        r.maxX = std::min(r.maxX, columns_ - 1);
+        r.maxY = std::min(r.maxY, rows_ - 1);
+        return r;
+    }
+
+    Rectangle TileGridCollider::tileRect_(const int x, const int y) const {
+        return Rectangle{origin_.x + static_cast<float>(x) * tileSize_.x,
+                         origin_.y + static_cast<float>(y) * tileSize_.y, tileSize_.x, tileSize_.y};
+    }
+
+    CollisionManifold TileGridCollider::collide(const Collider& other) const {
+        return collide_(other.convexSupport(), other.axisAlignedWorldBounds());
+    }
+
+    CollisionManifold TileGridCollider::collide(const ConvexSupport& shape) const {
+        if (shape.core.empty())
+            return {};
+        return collide_(shape, narrow_phase::bounds(shape));
+    }
+
+    CollisionManifold TileGridCollider::collide_(const ConvexSupport& support, const Rectangle& bounds) const {
+        if (support.core.empty())
+            return {};
+
+        const auto range = tilesIn_(bounds);
+        Vector2 pushMin{0.0f, 0.0f};
+        Vector2 pushMax{0.0f, 0.0f};
+        CollisionManifold deepest{};
+
+        for (auto y = range.minY; y <= range.maxY; ++y) {
+            for (auto x = range.minX; x <= range.maxX; ++x) {
+                if (!solid(x, y))
+                    continue;
+
+                const auto rect = tileRect_(x, y);
+                const TileShape tile(rect);
+                auto m = narrow_phase::convex(support, tile.support());
+                if (!m.colliding)
+                    continue;
+
+                // The collider leaves the tile along -normal. That is only valid through open faces: pushing
+                // through an edge shared with another solid tile is what makes colliders snag on seams.
+                const auto push = Vector2Negate(m.normal);
+                const bool blockedX = std::fabs(push.x) > axisTolerance && solid(x + (push.x > 0.0f ? 1 : -1), y);
+                const bool blockedY = std::fabs(push.y) > axisTolerance && solid(x, y + (push.y > 0.0f ? 1 : -1));
+                if (blockedX || blockedY) {
+                    // Fall back to the shallowest open face of the tile that faces the collider and that it can
+                    // leave through without crossing the whole tile; the far face of a floor tile at an inside
+                    // corner would push it through the floor.
+                    constexpr Vector2 faces[4] = {{1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f}};
+                    const float planes[4] = {rect.x + rect.width, -rect.x, rect.y + rect.height, -rect.y};
+                    const Vector2 offset{bounds.x + bounds.width * 0.5f - tile.center.x,
+                                         bounds.y + bounds.height * 0.5f - tile.center.y};
+                    bool open = false;
+                    for (int f = 0; f < 4; ++f) {
+                        if (solid(x + static_cast<int>(faces[f].x), y + static_cast<int>(faces[f].y)))
+                            continue;
+                        if (Vector2DotProduct(faces[f], offset) <= 0.0f)
+                            continue;
+                        const float depth = planes[f] - minProjection(support, faces[f]);
+                        const float extent = faces[f].x != 0.0f ? bounds.width : bounds.height;
+                        if (depth > extent)
+                            continue;
+                        if (!open || depth < m.depth) {
+                            m.normal = Vector2Negate(faces[f]);
+                            m.depth = depth;
+                            open = true;
+                        }
+                    }
+                    if (!open)
+                        // Buried tile, or one the collider only reaches past its neighbours; they report the contact
+                        continue;
+                }
+
+                const auto p = Vector2Scale(m.normal, -m.depth);
+                pushMin = Vector2{std::min(pushMin.x, p.x), std::min(pushMin.y, p.y)};
+                pushMax = Vector2{std::max(pushMax.x, p.x), std::max(pushMax.y, p.y)};
+                if (!deepest.colliding || m.depth > deepest.depth)
+                    deepest = m;
+            }
+        }
+
+        if (!deepest.colliding)
+            return deepest;
+
+        // Merge: the largest push along each direction, so a collider in a corner leaves both walls at once.
+        const auto total = Vector2Add(pushMin, pushMax);
+        const float length = Vector2Length(total);
+        if (length <= axisTolerance)
+            // Squeezed from opposite sides, or only touching
+            return deepest;
+
+        CollisionManifold m;
+        m.colliding = true;
+        m.normal = Vector2Scale(total, -1.0f / length);
+        m.depth = length;
+        return m;
+    }
+
+    bool TileGridCollider::overlaps(const ConvexSupport& shape) const {
+        if (shape.core.empty())
+            return false;
+
+        const auto range = tilesIn_(narrow_phase::bounds(shape));
+        for (auto y = range.minY; y <= range.maxY; ++y) {
+            for (auto x = range.minX; x <= range.maxX; ++x) {
+                if (solid(x, y) && narrow_phase::convexOverlap(shape, TileShape(tileRect_(x, y)).support()))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool TileGridCollider::castAgainst(const ConvexSupport& shape, const Vector2 motion, CastHit& hit) const {
+        if (shape.core.empty())
+            return false;
+
+        const auto start = narrow_phase::bounds(shape);
+        const Rectangle swept{std::min(start.x, start.x + motion.x), std::min(start.y, start.y + motion.y),
+                              start.width + std::fabs(motion.x), start.height + std::fabs(motion.y)};
+        const auto range = tilesIn_(swept);
+
+        bool found = false;
+        for (auto y = range.minY; y <= range.maxY; ++y) {
+            for (auto x = range.minX; x <= range.maxX; ++x) {
+                if (!solid(x, y))
+                    continue;
+                if (solid(x - 1, y) && solid(x + 1, y) && solid(x, y - 1) && solid(x, y + 1))
+                    // Buried: anything reaching it crosses a neighbour first
+                    continue;
+                CastHit candidate;
+                if (!narrow_phase::cast(shape, TileShape(tileRect_(x, y)).support(), motion, candidate))
+                    continue;
+                if (!found || candidate.fraction < hit.fraction) {
+                    hit = candidate;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    void TileGridCollider::rebuildGeometry(ColliderGeometry& g, const Transform* t) const {
+        origin_ = t ? t->position : Vector2{0.0f, 0.0f};
+        const float width = static_cast<float>(columns_) * tileSize_.x;
+        const float height = static_cast<float>(rows_) * tileSize_.y;
+        g.points = {origin_, Vector2{origin_.x + width, origin_.y}, Vector2{origin_.x + width, origin_.y + height},
+                    Vector2{origin_.x, origin_.y + height}};
+        g.normals.clear();
+        g.convex.count = 0;
+        g.bounds = Rectangle{origin_.x, origin_.y, width, height};
+    }
+
+    void TileGridCollider::draw() {
+        Collider::draw();
+        if (!debugEnabled())
+            return;
+
+        // Only the open edges of solid tiles, which are the ones that push
+        auto& rq = entity().scene().rq();
+        const auto color = colorForLayer(layer());
+        static_cast<void>(geometry());
+        for (auto y = 0; y < rows_; ++y) {
+            for (auto x = 0; x < columns_; ++x) {
+                if (!solid(x, y))
+                    continue;
+                const auto r = tileRect_(x, y);
+                const Vector2 tl{r.x, r.y};
+                const Vector2 tr{r.x + r.width, r.y};
+                const Vector2 br{r.x + r.width, r.y + r.height};
+                const Vector2 bl{r.x, r.y + r.height};
+                if (!solid(x, y - 1))
+                    rq.submitDebugLine(tl, tr, 2.0f, color);
+                if (!solid(x + 1, y))
+                    rq.submitDebugLine(tr, br, 2.0f, color);
+                if (!solid(x, y + 1))
+                    rq.submitDebugLine(br, bl, 2.0f, color);
+                if (!solid(x - 1, y))
+                    rq.submitDebugLine(bl, tl, 2.0f, color);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "raylib.h"
+#include "../collider.hpp"
+#include "../../tilemap.hpp"
+
+namespace rlge {
+    class BoxCollider;
+    class CircleCollider;
+    class ObbCollider;
+    class PolygonCollider;
+    class CapsuleCollider;
+    class CollisionSystem;
+    class Entity;
+
+    // Solid tiles of a grid, as a single static collider. A collider touching the grid is only tested against
+    // the tiles its bounds cover, and the per-tile contacts are merged into one manifold. Edges shared by two
+    // solid tiles never push, so colliders slide along floors and walls without catching on tile seams.
+    // Only the Transform's position is used, like Tilemap::draw; call CollisionSystem::invalidateStatic()
+    // after moving it.
+    class TileGridCollider final : public Collider {
+    public:
+        // solid holds columns * rows bytes, row-major; non-zero tiles are solid.
+        TileGridCollider(Entity& e,
+                         CollisionSystem& system,
+                         const ColliderType type,
+                         const ColliderLayerMask layer,
+                         const ColliderLayerMask mask,
+                         const int columns,
+                         const int rows,
+                         const Vector2 tileSize,
+                         std::vector<std::uint8_t> solid) :
+            Collider(e, system, type, layer, mask, false)
+            , columns_(columns)
+            , rows_(rows)
+            , tileSize_(tileSize)
+            , solid_(std::move(solid)) {
+            solid_.resize(static_cast<size_t>(columns_) * static_cast<size_t>(rows_));
+            setStatic(true);
+        }
+
+        // Takes the dimensions and Tilemap::solidity() of the map.
+        TileGridCollider(Entity& e,
+                         CollisionSystem& system,
+                         const ColliderType type,
+                         const ColliderLayerMask layer,
+                         const ColliderLayerMask mask,
+                         const Tilemap& map) :
+            TileGridCollider(e, system, type, layer, mask, map.mapWidth(), map.mapHeight(),
+                             Vector2{static_cast<float>(map.tileWidth()), static_cast<float>(map.tileHeight())},
+                             map.solidity()) {}
+
+        void draw() override;
+
+        [[nodiscard]] ColliderShape shape() const override { return ColliderShape::TileGrid; }
+
+        [[nodiscard]] CollisionManifold testAgainst(const Collider& other) const override {
+            return other.collideWith(*this);
+        }
+
+        [[nodiscard]] CollisionManifold collideWith(const BoxCollider& b) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CircleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const ObbCollider& o) const override;
+        [[nodiscard]] CollisionManifold collideWith(const PolygonCollider& p) const override;
+        [[nodiscard]] CollisionManifold collideWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] CollisionManifold collideWith(const TileGridCollider&) const override { return {}; }
+
+        [[nodiscard]] bool testOverlap(const Collider& other) const override {
+            return other.overlapWith(*this);
+        }
+
+        [[nodiscard]] bool overlapWith(const BoxCollider& b) const override;
+        [[nodiscard]] bool overlapWith(const CircleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const ObbCollider& o) const override;
+        [[nodiscard]] bool overlapWith(const PolygonCollider& p) const override;
+        [[nodiscard]] bool overlapWith(const CapsuleCollider& c) const override;
+        [[nodiscard]] bool overlapWith(const TileGridCollider&) const override { return false; }
+
+        // The grid is not one convex shape; queries and the narrow phase go through the tiles instead.
+        [[nodiscard]] ConvexSupport convexSupport() const override { return {}; }
+
+        [[nodiscard]] bool overlaps(const ConvexSupport& shape) const override;
+        [[nodiscard]] bool castAgainst(const ConvexSupport& shape, Vector2 motion, CastHit& hit) const override;
+
+        // Merged contact of `other` with the solid tiles, normal pointing from other to the grid.
+        [[nodiscard]] CollisionManifold collide(const Collider& other) const;
+        // The same for a support-mapped shape, such as one piece of a compound collider.
+        [[nodiscard]] CollisionManifold collide(const ConvexSupport& shape) const;
+
+        [[nodiscard]] int columns() const { return columns_; }
+        [[nodiscard]] int rows() const { return rows_; }
+        [[nodiscard]] Vector2 tileSize() const { return tileSize_; }
+
+        [[nodiscard]] bool solid(const int x, const int y) const {
+            return x >= 0 && y >= 0 && x < columns_ && y < rows_ && solid_[y * columns_ + x] != 0;
+        }
+
+        void setSolid(int x, int y, bool solid);
+
+    protected:
+        void rebuildGeometry(ColliderGeometry& g, const Transform* t) const override;
+
+    private:
+        struct TileRange {
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        [[nodiscard]] CollisionManifold collide_(const ConvexSupport& support, const Rectangle& bounds) const;
+        [[nodiscard]] TileRange tilesIn_(const Rectangle& bounds) const;
+        [[nodiscard]] Rectangle tileRect_(int x, int y) const;
+
+        int columns_;
+        int rows_;
+        Vector2 tileSize_;
+        std::vector<std::uint8_t> solid_;
+        mutable Vector2 origin_{0.0f, 0.0f};
+    };
+}
@@ -0,0 +1,205 @@
+#include "spatial_hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace rlge {
+
+    namespace {
+        std::uint32_t hashCell(const std::int32_t x, const std::int32_t y, const std::uint32_t bucketMask) {
+            // Large primes from Teschner et al., "Optimized Spatial Hashing for Collision Detection".
+            const auto h = static_cast<std::uint32_t>(x) * 73856093u ^ static_cast<std::uint32_t>(y) * 19349663u;
+            return h & bucketMask;
+        }
+    }
+
+    SpatialHash::SpatialHash(const BroadPhaseConfig& config) :
+        cellSize_(1.0f), invCellSize_(1.0f) {
+        setCellSize(config.cellSize);
+    }
+
+    void SpatialHash::configure(const BroadPhaseConfig& config) {
+        setCellSize(config.cellSize);
+    }
+
+    void SpatialHash::setCellSize(const float cellSize) {
+        cellSize_ = std::max(cellSize, 1.0f);
+        invCellSize_ = 1.0f / cellSize_;
+    }
+
+    ProxyId SpatialHash::createProxy(Collider* collider, const Rectangle& bounds) {
+        ProxyId id;
+        if (!free_.empty()) {
+            id = free_.back();
+            free_.pop_back();
+        }
+        else {
+            id = static_cast<ProxyId>(proxies_.size());
+            proxies_.emplace_back();
+        }
+
+        proxies_[id].collider = collider;
+        proxies_[id].bounds = bounds;
+        return id;
+    }
+
+    void SpatialHash::destroyProxy(const ProxyId proxy) {
+        proxies_[proxy] = Proxy{};
+        free_.push_back(proxy);
+    }
+
+    void SpatialHash::moveProxy(const ProxyId proxy, const Rectangle& bounds) {
+        proxies_[proxy].bounds = bounds;
+    }
+
+    std::int32_t SpatialHash::cellCoord_(const float v) const {
+        return static_cast<std::int32_t>(std::floor(v * invCellSize_));
+    }
+
+    bool SpatialHash::firstSharedCell_(const Entry& e, const Proxy& a, const Proxy& b) const {
+        // Two proxies may share several cells; only the cell at the minimum corner of the overlap reports them.
+        return e.cellX == std::max(a.cells.minX, b.cells.minX) && e.cellY == std::max(a.cells.minY, b.cells.minY);
+    }
+
+    void SpatialHash::rebuild_() {
+        oversized_.clear();
+        entries_.clear();
+
+        for (ProxyId id = 0; id < static_cast<ProxyId>(proxies_.size()); ++id) {
+            auto& p = proxies_[id];
+            if (!p.collider)
+                continue;
+
+            const auto& b = p.bounds;
+            p.cells = CellRange{
+                cellCoord_(b.x),
+                cellCoord_(b.y),
+                cellCoord_(b.x + b.width),
+                cellCoord_(b.y + b.height)
+            };
+
+            const std::int64_t spanX = static_cast<std::int64_t>(p.cells.maxX) - p.cells.minX + 1;
+            const std::int64_t spanY = static_cast<std::int64_t>(p.cells.maxY) - p.cells.minY + 1;
+            p.oversized = spanX * spanY > maxCellsPerProxy_;
+            if (p.oversized) {
+                oversized_.push_back(id);
+                continue;
+            }
+
+            for (auto y = p.cells.minY; y <= p.cells.maxY; ++y) {
+                for (auto x = p.cells.minX; x <= p.cells.maxX; ++x) {
+                    entries_.push_back(Entry{x, y, id});
+                }
+            }
+        }
+    }
+
+    void SpatialHash::refresh() {
+        rebuild_();
+        if (entries_.empty())
+            return;
+
+        // Counting sort of the cell entries into hash buckets keeps the whole pass linear.
+        const auto bucketCount = std::bit_ceil(static_cast<std::uint32_t>(entries_.size() * 2));
+        const auto bucketMask = bucketCount - 1;
+
+        bucketStarts_.assign(bucketCount + 1, 0);
+        for (const auto& e : entries_) {
+            ++bucketStarts_[hashCell(e.cellX, e.cellY, bucketMask) + 1];
+        }
+        for (std::uint32_t i = 0; i < bucketCount; ++i) {
+            bucketStarts_[i + 1] += bucketStarts_[i];
+        }
+
+        sorted_.resize(entries_.size());
+        for (const auto& e : entries_) {
+            sorted_[bucketStarts_[hashCell(e.cellX, e.cellY, bucketMask)]++] = e;
+        }
+    }
+
+    void SpatialHash::collectPairs(std::vector<ColliderPair>& out) {
+        refresh();
+
+        if (!entries_.empty()) {
+            // bucketStarts_[i] now holds the end of bucket i, which is the start of bucket i + 1.
+            const auto bucketCount = static_cast<std::uint32_t>(bucketStarts_.size() - 1);
+            std::uint32_t begin = 0;
+            for (std::uint32_t bucket = 0; bucket < bucketCount; ++bucket) {
+                const std::uint32_t end = bucketStarts_[bucket];
+                for (auto p = begin; p < end; ++p) {
+                    const auto& ep = sorted_[p];
+                    for (auto q = p + 1; q < end; ++q) {
+                        const auto& eq = sorted_[q];
+                        if (ep.cellX != eq.cellX || ep.cellY != eq.cellY)
+                            // Different cells that happen to hash into the same bucket
+                            continue;
+
+                        const auto& a = proxies_[ep.proxy];
+                        const auto& b = proxies_[eq.proxy];
+                        if (!firstSharedCell_(ep, a, b))
+                            continue;
+
+                        out.push_back(ColliderPair{a.collider, b.collider});
+                    }
+                }
+                begin = end;
+            }
+        }
+
+        for (const auto o : oversized_) {
+            for (ProxyId k = 0; k < static_cast<ProxyId>(proxies_.size()); ++k) {
+                const auto& other = proxies_[k];
+                if (k == o || !other.collider)
+                    continue;
+                if (other.oversized && k < o)
+                    // Oversized vs. oversized pairs are reported by the lower proxy only
+                    continue;
+                out.push_back(ColliderPair{proxies_[o].collider, other.collider});
+            }
+        }
+    }
+
+    void SpatialHash::query(const Aabb& box, std::vector<Collider*>& out) const {
+        const CellRange cells{cellCoord_(box.minX), cellCoord_(box.minY), cellCoord_(box.maxX), cellCoord_(box.maxY)};
+        const std::int64_t spanX = static_cast<std::int64_t>(cells.maxX) - cells.minX + 1;
+        const std::int64_t spanY = static_cast<std::int64_t>(cells.maxY) - cells.minY + 1;
+
+        if (entries_.empty() || spanX * spanY > maxCellsPerProxy_) {
+            // Covers too many cells to visit them one by one; every proxy is a cheaper walk.
+            for (const auto& p : proxies_) {
+                if (p.collider && Aabb::fromRect(p.bounds).overlaps(box))
+                    out.push_back(p.collider);
+            }
+            return;
+        }
+
+        // bucketStarts_ holds the end of every bucket since the last refresh.
+        const auto bucketMask = static_cast<std::uint32_t>(bucketStarts_.size() - 2);
+        for (auto y = cells.minY; y <= cells.maxY; ++y) {
+            for (auto x = cells.minX; x <= cells.maxX; ++x) {
+                const auto bucket = hashCell(x, y, bucketMask);
+                const auto begin = bucket == 0 ? 0u : bucketStarts_[bucket - 1];
+                for (auto i = begin; i < bucketStarts_[bucket]; ++i) {
+                    const auto& e = sorted_[i];
+                    if (e.cellX != x || e.cellY != y)
+                        continue;
+                    const auto& p = proxies_[e.proxy];
+                    // A proxy spanning several of the queried cells is reported by the first one only.
+                    if (!p.collider || x != std::max(p.cells.minX, cells.minX) ||
+                        y != std::max(p.cells.minY, cells.minY))
+                        continue;
+                    if (Aabb::fromRect(p.bounds).overlaps(box))
+                        out.push_back(p.collider);
+                }
+            }
+        }
+
+        for (const auto o : oversized_) {
+            const auto& p = proxies_[o];
+            if (p.collider && Aabb::fromRect(p.bounds).overlaps(box))
+                out.push_back(p.collider);
+        }
+    }
+
+}
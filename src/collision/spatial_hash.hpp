@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "raylib.h"
+
+namespace rlge {
+
+    // Uniform grid broad phase. Bounds are bucketed into square cells through a hashed cell table, and
+    // only proxies sharing a cell are reported as candidate pairs. The grid is rebuilt from scratch every
+    // frame; all internal buffers are reused so steady-state frames do not allocate.
+    class SpatialHash final : public BroadPhase {
+    public:
+        explicit SpatialHash(const BroadPhaseConfig& config = {});
+
+        ProxyId createProxy(Collider* collider, const Rectangle& bounds) override;
+        void destroyProxy(ProxyId proxy) override;
+        void moveProxy(ProxyId proxy, const Rectangle& bounds) override;
+        void collectPairs(std::vector<ColliderPair>& out) override;
+        void refresh() override;
+        void query(const Aabb& box, std::vector<Collider*>& out) const override;
+        void configure(const BroadPhaseConfig& config) override;
+
+        void setCellSize(float cellSize);
+        [[nodiscard]] float cellSize() const { return cellSize_; }
+
+    private:
+        struct CellRange {
+            std::int32_t minX;
+            std::int32_t minY;
+            std::int32_t maxX;
+            std::int32_t maxY;
+        };
+
+        struct Proxy {
+            Collider* collider = nullptr;
+            Rectangle bounds{};
+            CellRange cells{};
+            bool oversized = false;
+        };
+
+        struct Entry {
+            std::int32_t cellX;
+            std::int32_t cellY;
+            ProxyId proxy;
+        };
+
+        // Proxies spanning more cells than this are kept out of the grid and paired against everything.
+        static constexpr std::int64_t maxCellsPerProxy_ = 64;
+
+        [[nodiscard]] std::int32_t cellCoord_(float v) const;
+        [[nodiscard]] bool firstSharedCell_(const Entry& e, const Proxy& a, const Proxy& b) const;
+        void rebuild_();
+
+        float cellSize_;
+        float invCellSize_;
+        std::vector<Proxy> proxies_;
+        std::vector<ProxyId> free_;
+        std::vector<ProxyId> oversized_;
+        std::vector<Entry> entries_;
+        std::vector<Entry> sorted_;
+        std::vector<std::uint32_t> bucketStarts_;
+    };
+
+}
@@ -0,0 +1,63 @@
+#include "static_bvh.hpp"
+
+#include <algorithm>
+
+#include "collider.hpp"
+
+namespace rlge {
+
+    void StaticBvh::clear() {
+        items_.clear();
+        nodes_.clear();
+    }
+
+    void StaticBvh::build(const std::span<Collider* const> colliders) {
+        clear();
+        items_.reserve(colliders.size());
+        for (auto* c : colliders) {
+            items_.push_back(Item{Aabb::fromRect(c->axisAlignedWorldBounds()), c});
+        }
+
+        if (items_.empty())
+            return;
+
+        nodes_.reserve(2 * items_.size() / maxLeafItems_ + 1);
+        build_(0, static_cast<std::uint32_t>(items_.size()));
+    }
+
+    std::uint32_t StaticBvh::build_(const std::uint32_t begin, const std::uint32_t end) {
+        const auto index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back(Node{items_[begin].box, begin, end - begin});
+
+        Aabb bounds = items_[begin].box;
+        Aabb centroids{bounds.minX + bounds.maxX, bounds.minY + bounds.maxY,
+                       bounds.minX + bounds.maxX, bounds.minY + bounds.maxY};
+        for (auto i = begin + 1; i < end; ++i) {
+            const auto& b = items_[i].box;
+            bounds = Aabb::merge(bounds, b);
+            const float cx = b.minX + b.maxX;
+            const float cy = b.minY + b.maxY;
+            centroids = Aabb::merge(centroids, Aabb{cx, cy, cx, cy});
+        }
+        nodes_[index].box = bounds;
+
+        if (end - begin <= maxLeafItems_)
+            return index;
+
+        // Median split along the axis where the item centres are spread the most.
+        const bool splitX = (centroids.maxX - centroids.minX) >= (centroids.maxY - centroids.minY);
+        const auto mid = begin + (end - begin) / 2;
+        std::nth_element(items_.begin() + begin, items_.begin() + mid, items_.begin() + end,
+                         [splitX](const Item& l, const Item& r) {
+                             return splitX ? (l.box.minX + l.box.maxX) < (r.box.minX + r.box.maxX)
+                                           : (l.box.minY + l.box.maxY) < (r.box.minY + r.box.maxY);
+                         });
+
+        build_(begin, mid);
+        const auto right = build_(mid, end);
+        nodes_[index].start = right;
+        nodes_[index].count = 0;
+        return index;
+    }
+
+}
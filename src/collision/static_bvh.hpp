@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "broad_phase.hpp"
+
+namespace rlge {
+    class Collider;
+
+    // Immutable bounding volume hierarchy for colliders that never move. Built top-down in one go from the
+    // colliders' current bounds and stored as a flat, depth-first node array. It is only rebuilt when the set
+    // of static colliders changes, so static level geometry costs nothing per frame beyond the queries.
+    class StaticBvh {
+    public:
+        void build(std::span<Collider* const> colliders);
+        void clear();
+
+        [[nodiscard]] bool empty() const { return items_.empty(); }
+        [[nodiscard]] std::size_t size() const { return items_.size(); }
+
+        // Calls fn(collider) for every static collider whose bounds overlap the box.
+        template <typename Fn>
+        void query(const Aabb& box, Fn&& fn) const;
+
+    private:
+        struct Item {
+            Aabb box;
+            Collider* collider;
+        };
+
+        struct Node {
+            Aabb box;
+            std::uint32_t start; // first item for leaves, index of the second child for internal nodes
+            std::uint32_t count; // number of items for leaves, 0 for internal nodes (first child is the next node)
+        };
+
+        static constexpr std::uint32_t maxLeafItems_ = 4;
+
+        std::uint32_t build_(std::uint32_t begin, std::uint32_t end);
+
+        std::vector<Item> items_;
+        std::vector<Node> nodes_;
+        mutable std::vector<std::uint32_t> stack_;
+    };
+
+    template <typename Fn>
+    void StaticBvh::query(const Aabb& box, Fn&& fn) const {
+        if (nodes_.empty())
+            return;
+
+        stack_.clear();
+        stack_.push_back(0);
+        while (!stack_.empty()) {
+            const auto index = stack_.back();
+            stack_.pop_back();
+
+            const auto& node = nodes_[index];
+            if (!node.box.overlaps(box))
+                continue;
+
+            if (node.count > 0) {
+                for (auto i = node.start; i < node.start + node.count; ++i) {
+                    if (items_[i].box.overlaps(box))
+                        fn(items_[i].collider);
+                }
+            }
+            else {
+                stack_.push_back(node.start);
+                stack_.push_back(index + 1);
+            }
+        }
+    }
+
+}
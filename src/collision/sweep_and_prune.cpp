@@ -0,0 +1,232 @@
+#include "sweep_and_prune.hpp"
+
+#include <algorithm>
+
+namespace rlge {
+
+    SweepAndPrune::SweepAndPrune(const BroadPhaseConfig&) {}
+
+    bool SweepAndPrune::less_(const Endpoint& l, const Endpoint& r) {
+        // On ties a min sorts before a max, so touching boxes count as overlapping like Aabb::overlaps.
+        if (l.value != r.value)
+            return l.value < r.value;
+        return !l.isMax() && r.isMax();
+    }
+
+    std::uint64_t SweepAndPrune::pairKey_(const ProxyId a, const ProxyId b) {
+        const auto lo = static_cast<std::uint64_t>(std::min(a, b));
+        const auto hi = static_cast<std::uint64_t>(std::max(a, b));
+        return lo << 32 | hi;
+    }
+
+    ProxyId SweepAndPrune::createProxy(Collider* collider, const Rectangle& bounds) {
+        ProxyId id;
+        if (!free_.empty()) {
+            id = free_.back();
+            free_.pop_back();
+        }
+        else {
+            id = static_cast<ProxyId>(proxies_.size());
+            proxies_.emplace_back();
+        }
+
+        auto& p = proxies_[id];
+        p.collider = collider;
+        p.box = Aabb::fromRect(bounds);
+        p.alive = true;
+
+        // New endpoints start at the end of each list, as if they came from +infinity. The next sort pass moves
+        // them into place and reports their overlaps like any other crossing.
+        for (int axis = 0; axis < 2; ++axis) {
+            auto& list = axes_[axis];
+            p.endpoints[axis][0] = static_cast<std::uint32_t>(list.size());
+            list.push_back(Endpoint{0.0f, static_cast<std::uint32_t>(id) << 1});
+            p.endpoints[axis][1] = static_cast<std::uint32_t>(list.size());
+            list.push_back(Endpoint{0.0f, static_cast<std::uint32_t>(id) << 1 | 1u});
+        }
+        setEndpoints_(id);
+        ++added_;
+        return id;
+    }
+
+    void SweepAndPrune::destroyProxy(const ProxyId proxy) {
+        // Endpoints are removed in one batch on the next refresh; until then the id is not reused.
+        auto& p = proxies_[proxy];
+        p.alive = false;
+        p.collider = nullptr;
+        destroyed_.push_back(proxy);
+    }
+
+    void SweepAndPrune::moveProxy(const ProxyId proxy, const Rectangle& bounds) {
+        proxies_[proxy].box = Aabb::fromRect(bounds);
+        setEndpoints_(proxy);
+    }
+
+    void SweepAndPrune::setEndpoints_(const ProxyId proxy) {
+        const auto& p = proxies_[proxy];
+        axes_[0][p.endpoints[0][0]].value = p.box.minX;
+        axes_[0][p.endpoints[0][1]].value = p.box.maxX;
+        axes_[1][p.endpoints[1][0]].value = p.box.minY;
+        axes_[1][p.endpoints[1][1]].value = p.box.maxY;
+    }
+
+    void SweepAndPrune::addPair_(const ProxyId a, const ProxyId b) {
+        const auto key = pairKey_(a, b);
+        if (pairIndex_.contains(key))
+            return;
+        pairIndex_.emplace(key, static_cast<std::uint32_t>(pairs_.size()));
+        pairs_.push_back(ProxyPair{std::min(a, b), std::max(a, b)});
+    }
+
+    void SweepAndPrune::removePair_(const ProxyId a, const ProxyId b) {
+        const auto it = pairIndex_.find(pairKey_(a, b));
+        if (it == pairIndex_.end())
+            return;
+
+        // Swap-remove, keeping the index of the moved pair up to date.
+        const auto index = it->second;
+        pairIndex_.erase(it);
+        if (index + 1 != pairs_.size()) {
+            pairs_[index] = pairs_.back();
+            pairIndex_[pairKey_(pairs_[index].a, pairs_[index].b)] = index;
+        }
+        pairs_.pop_back();
+    }
+
+    void SweepAndPrune::sortAxis_(const int axis) {
+        auto& list = axes_[axis];
+        const auto n = static_cast<std::uint32_t>(list.size());
+
+        for (std::uint32_t i = 1; i < n; ++i) {
+            const Endpoint key = list[i];
+            const ProxyId keyProxy = key.proxy();
+            std::uint32_t j = i;
+
+            while (j > 0 && less_(key, list[j - 1])) {
+                const Endpoint other = list[j - 1];
+                const ProxyId otherProxy = other.proxy();
+
+                if (keyProxy != otherProxy && key.isMax() != other.isMax()) {
+                    const auto& pk = proxies_[keyProxy];
+                    const auto& po = proxies_[otherProxy];
+                    if (!key.isMax()) {
+                        // A min moved below a max: the intervals start overlapping on this axis.
+                        if (pk.alive && po.alive && pk.box.overlaps(po.box))
+                            addPair_(keyProxy, otherProxy);
+                    }
+                    else {
+                        // A max moved below a min: the intervals stop overlapping on this axis.
+                        removePair_(keyProxy, otherProxy);
+                    }
+                }
+
+                list[j] = other;
+                proxies_[otherProxy].endpoints[axis][other.isMax() ? 1 : 0] = j;
+                --j;
+            }
+
+            list[j] = key;
+            proxies_[keyProxy].endpoints[axis][key.isMax() ? 1 : 0] = j;
+        }
+    }
+
+    void SweepAndPrune::rebuild_() {
+        // Too many new proxies for insertion sort to be cheap: sort from scratch and run a single sweep on x.
+        pairs_.clear();
+        pairIndex_.clear();
+
+        for (int axis = 0; axis < 2; ++axis) {
+            auto& list = axes_[axis];
+            std::ranges::sort(list, less_);
+            for (std::uint32_t i = 0; i < list.size(); ++i) {
+                proxies_[list[i].proxy()].endpoints[axis][list[i].isMax() ? 1 : 0] = i;
+            }
+        }
+
+        active_.clear();
+        for (const auto& e : axes_[0]) {
+            const ProxyId id = e.proxy();
+            if (!proxies_[id].alive)
+                continue;
+
+            if (e.isMax()) {
+                std::erase(active_, id);
+                continue;
+            }
+
+            const auto& box = proxies_[id].box;
+            for (const ProxyId other : active_) {
+                if (box.overlaps(proxies_[other].box))
+                    addPair_(id, other);
+            }
+            active_.push_back(id);
+        }
+    }
+
+    void SweepAndPrune::compact_() {
+        std::erase_if(pairs_, [this](const ProxyPair& p) {
+            return !proxies_[p.a].alive || !proxies_[p.b].alive;
+        });
+        pairIndex_.clear();
+        for (std::uint32_t i = 0; i < pairs_.size(); ++i) {
+            pairIndex_.emplace(pairKey_(pairs_[i].a, pairs_[i].b), i);
+        }
+
+        for (int axis = 0; axis < 2; ++axis) {
+            auto& list = axes_[axis];
+            std::erase_if(list, [this](const Endpoint& e) { return !proxies_[e.proxy()].alive; });
+            for (std::uint32_t i = 0; i < list.size(); ++i) {
+                proxies_[list[i].proxy()].endpoints[axis][list[i].isMax() ? 1 : 0] = i;
+            }
+        }
+
+        free_.insert(free_.end(), destroyed_.begin(), destroyed_.end());
+        destroyed_.clear();
+    }
+
+    void SweepAndPrune::refresh() {
+        if (!destroyed_.empty())
+            compact_();
+
+        const auto total = axes_[0].size() / 2;
+        if (added_ > 0 && added_ * 4 >= total) {
+            rebuild_();
+        }
+        else {
+            sortAxis_(0);
+            sortAxis_(1);
+        }
+        added_ = 0;
+
+        maxWidth_ = 0.0f;
+        for (const auto& p : proxies_) {
+            if (p.alive)
+                maxWidth_ = std::max(maxWidth_, p.box.maxX - p.box.minX);
+        }
+    }
+
+    void SweepAndPrune::collectPairs(std::vector<ColliderPair>& out) {
+        // The overlapping pairs are maintained by the sort itself.
+        refresh();
+        out.reserve(out.size() + pairs_.size());
+        for (const auto& [a, b] : pairs_) {
+            out.push_back(ColliderPair{proxies_[a].collider, proxies_[b].collider});
+        }
+    }
+
+    void SweepAndPrune::query(const Aabb& box, std::vector<Collider*>& out) const {
+        // No proxy overlapping the box can start further left than the widest one reaches, so only the min
+        // endpoints in [box.minX - maxWidth_, box.maxX] on the sorted x axis need a look.
+        const auto& list = axes_[0];
+        const Endpoint from{box.minX - maxWidth_, 0u};
+        auto it = std::lower_bound(list.begin(), list.end(), from, less_);
+        for (; it != list.end() && it->value <= box.maxX; ++it) {
+            if (it->isMax())
+                continue;
+            const auto& p = proxies_[it->proxy()];
+            if (p.alive && p.box.overlaps(box))
+                out.push_back(p.collider);
+        }
+    }
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "broad_phase.hpp"
+#include "raylib.h"
+
+namespace rlge {
+
+    // Incremental sweep and prune on both axes. Sorted min/max endpoint lists persist between frames and are
+    // re-sorted with insertion sort, which is close to linear when colliders only move a little. Every swap of
+    // a min and a max endpoint is an overlap starting or ending on that axis, so the pair set is updated as
+    // endpoints cross instead of being recomputed.
+    class SweepAndPrune final : public BroadPhase {
+    public:
+        explicit SweepAndPrune(const BroadPhaseConfig& config = {});
+
+        ProxyId createProxy(Collider* collider, const Rectangle& bounds) override;
+        void destroyProxy(ProxyId proxy) override;
+        void moveProxy(ProxyId proxy, const Rectangle& bounds) override;
+        void collectPairs(std::vector<ColliderPair>& out) override;
+        void refresh() override;
+        void query(const Aabb& box, std::vector<Collider*>& out) const override;
+
+    private:
+        struct Endpoint {
+            float value;
+            std::uint32_t data; // proxy id << 1 | 1 for a max endpoint
+
+            [[nodiscard]] ProxyId proxy() const { return static_cast<ProxyId>(data >> 1); }
+            [[nodiscard]] bool isMax() const { return (data & 1u) != 0; }
+        };
+
+        struct Proxy {
+            Collider* collider = nullptr;
+            Aabb box;
+            std::uint32_t endpoints[2][2]{}; // [axis][min, max] positions in axes_
+            bool alive = false;
+        };
+
+        struct ProxyPair {
+            ProxyId a;
+            ProxyId b;
+        };
+
+        [[nodiscard]] static bool less_(const Endpoint& l, const Endpoint& r);
+        [[nodiscard]] static std::uint64_t pairKey_(ProxyId a, ProxyId b);
+        void setEndpoints_(ProxyId proxy);
+        void sortAxis_(int axis);
+        void rebuild_();
+        void compact_();
+        void addPair_(ProxyId a, ProxyId b);
+        void removePair_(ProxyId a, ProxyId b);
+
+        std::vector<Proxy> proxies_;
+        std::vector<ProxyId> free_;
+        std::vector<ProxyId> destroyed_;
+        std::vector<Endpoint> axes_[2];
+        std::vector<ProxyPair> pairs_;
+        std::unordered_map<std::uint64_t, std::uint32_t> pairIndex_;
+        std::vector<ProxyId> active_;
+        std::size_t added_ = 0;
+        float maxWidth_ = 0.0f; // widest live proxy on x at the last refresh, bounds the query scan
+    };
+
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "narrow_phase.hpp"
+#include "raymath.h"
+
+// Swept box and circle tests for continuous collision. Every case is reduced to a ray (a's center moving by
+// `motion`) against b grown by a's extent: a box, a circle, or a box with rounded corners.
+
+namespace rlge::narrow_phase {
+
+    namespace {
+        constexpr float epsilon = 1e-6f;
+        // Shapes that start this close together count as touching rather than overlapping, so a collider that
+        // was stopped against a wall last frame is still swept into it on the next one.
+        constexpr float touchSlop = 1e-3f;
+
+        // Ray against an axis-aligned box, slab method. Returns the entry time and the normal of the entered face,
+        // which points from the ray towards the box. Fails when the ray misses, moves away or starts inside.
+        bool rayBox(const Vector2 origin, const Vector2 motion, const float minX, const float minY, const float maxX,
+                    const float maxY, float& outT, Vector2& outNormal) {
+            const float length = Vector2Length(motion);
+            if (length < epsilon)
+                return false;
+
+            float tEnter = -std::numeric_limits<float>::max();
+            float tExit = std::numeric_limits<float>::max();
+            Vector2 normal{0.0f, 0.0f};
+
+            const float origins[2] = {origin.x, origin.y};
+            const float deltas[2] = {motion.x, motion.y};
+            const float mins[2] = {minX, minY};
+            const float maxs[2] = {maxX, maxY};
+
+            for (int axis = 0; axis < 2; ++axis) {
+                if (std::fabs(deltas[axis]) < epsilon) {
+                    if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+                        return false;
+                    continue;
+                }
+
+                const float inv = 1.0f / deltas[axis];
+                float t0 = (mins[axis] - origins[axis]) * inv;
+                float t1 = (maxs[axis] - origins[axis]) * inv;
+                // Entering through the min face means travelling in +axis, so the normal is +axis as well.
+                float sign = 1.0f;
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                    sign = -1.0f;
+                }
+
+                if (t0 > tEnter) {
+                    tEnter = t0;
+                    normal = axis == 0 ? Vector2{sign, 0.0f} : Vector2{0.0f, sign};
+                }
+                tExit = std::min(tExit, t1);
+            }
+
+            if (tEnter > tExit || tExit <= 0.0f || tEnter > 1.0f)
+                return false;
+            if (tEnter * length < -touchSlop)
+                // Started inside; the discrete test owns that overlap
+                return false;
+
+            outT = std::max(tEnter, 0.0f);
+            outNormal = normal;
+            return true;
+        }
+
+        // Ray against a circle. Fails when the ray misses within the frame, moves away or starts inside.
+        bool rayCircle(const Vector2 origin, const Vector2 motion, const Vector2 center, const float radius,
+                       float& outT) {
+            const auto m = Vector2Subtract(origin, center);
+            const float a = Vector2DotProduct(motion, motion);
+            const float b = Vector2DotProduct(m, motion);
+            const float c = Vector2DotProduct(m, m) - radius * radius;
+            if (b >= 0.0f || a < epsilon)
+                return false;
+            if (c <= 0.0f) {
+                if (Vector2Length(m) < radius - touchSlop)
+                    return false;
+                outT = 0.0f;
+                return true;
+            }
+
+            const float discriminant = b * b - a * c;
+            if (discriminant < 0.0f)
+                return false;
+
+            const float t = (-b - std::sqrt(discriminant)) / a;
+            if (t > 1.0f)
+                return false;
+            outT = std::max(t, 0.0f);
+            return true;
+        }
+
+        // Circle moving against a box: the box grows by the radius, with rounded corners.
+        bool sweepCircleBox(const Vector2 center, const float radius, const Rectangle& box, const Vector2 motion,
+                            float& outT, Vector2& outNormal) {
+            const float minX = box.x;
+            const float minY = box.y;
+            const float maxX = box.x + box.width;
+            const float maxY = box.y + box.height;
+
+            float t;
+            Vector2 normal;
+            if (!rayBox(center, motion, minX - radius, minY - radius, maxX + radius, maxY + radius, t, normal))
+                return false;
+
+            const auto hit = Vector2Add(center, Vector2Scale(motion, t));
+            const bool outsideX = hit.x < minX || hit.x > maxX;
+            const bool outsideY = hit.y < minY || hit.y > maxY;
+            if (!(outsideX && outsideY)) {
+                outT = t;
+                outNormal = normal;
+                return true;
+            }
+
+            // The hit lies in a corner region, where the grown box is a quarter circle around the corner.
+            const Vector2 corner{hit.x < minX ? minX : maxX, hit.y < minY ? minY : maxY};
+            if (!rayCircle(center, motion, corner, radius, t))
+                return false;
+            outT = t;
+            outNormal = Vector2Normalize(Vector2Subtract(corner, Vector2Add(center, Vector2Scale(motion, t))));
+            return true;
+        }
+    }
+
+    CollisionManifold timeOfImpact(const SweptShape& a, const SweptShape& b, const Vector2 motion) {
+        CollisionManifold m{};
+
+        float t = 0.0f;
+        Vector2 normal{0.0f, 0.0f};
+        bool hit;
+        if (a.radius > 0.0f && b.radius > 0.0f) {
+            hit = rayCircle(a.center, motion, b.center, a.radius + b.radius, t);
+            if (hit)
+                normal = Vector2Normalize(Vector2Subtract(b.center, Vector2Add(a.center, Vector2Scale(motion, t))));
+        }
+        else if (a.radius > 0.0f) {
+            hit = sweepCircleBox(a.center, a.radius, b.bounds, motion, t, normal);
+        }
+        else if (b.radius > 0.0f) {
+            // Let the circle move instead, against the opposite motion, and flip the normal back.
+            hit = sweepCircleBox(b.center, b.radius, a.bounds, Vector2Negate(motion), t, normal);
+            normal = Vector2Negate(normal);
+        }
+        else {
+            // Box against box: the center of a against b grown by a's half extents
+            const float hx = a.bounds.width * 0.5f;
+            const float hy = a.bounds.height * 0.5f;
+            const Vector2 center{a.bounds.x + hx, a.bounds.y + hy};
+            hit = rayBox(center, motion, b.bounds.x - hx, b.bounds.y - hy,
+                         b.bounds.x + b.bounds.width + hx, b.bounds.y + b.bounds.height + hy, t, normal);
+        }
+
+        if (!hit)
+            return m;
+
+        m.colliding = true;
+        m.normal = normal;
+        m.toi = t;
+        m.depth = std::max(0.0f, Vector2DotProduct(Vector2Scale(motion, 1.0f - t), normal));
+        return m;
+    }
+
+}
@@ -0,0 +1,63 @@
+#include "worker_pool.hpp"
+
+namespace rlge {
+
+    WorkerPool::WorkerPool(const unsigned workers) {
+        threads_.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { work_(i + 1); });
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    void WorkerPool::run(const std::function<void(unsigned)>& job) {
+        if (threads_.empty()) {
+            job(0);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            job_ = &job;
+            pending_ = static_cast<unsigned>(threads_.size());
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        job(0);
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+    void WorkerPool::work_(const unsigned slot) {
+        std::uint64_t seen = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            const auto* job = job_;
+
+            lock.unlock();
+            (*job)(slot);
+            lock.lock();
+
+            if (--pending_ == 0)
+                done_.notify_one();
+        }
+    }
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rlge {
+
+    // Small fork-join pool for splitting one batch of work across cores. run() hands every slot to exactly one
+    // thread: slot 0 runs on the caller, the others on the workers, and it returns once all slots are done.
+    class WorkerPool {
+    public:
+        explicit WorkerPool(unsigned workers);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Number of slots per run: the worker threads plus the calling thread.
+        [[nodiscard]] unsigned slots() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+        // Calls job(slot) once for every slot in [0, slots()). The job must not throw.
+        void run(const std::function<void(unsigned)>& job);
+
+    private:
+        void work_(unsigned slot);
+
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const std::function<void(unsigned)>* job_ = nullptr;
+        std::uint64_t generation_ = 0;
+        unsigned pending_ = 0;
+        bool stop_ = false;
+    };
+}
@@ -1,7 +1,44 @@
 #include "render_queue.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <cmath>
+
+#include "rlgl.h"
+
+namespace {
+    // Stable LSD radix sort of keys by their upper 32 bits, 11 bits per pass. A pass where all keys share the
+    // digit is skipped, so a batch on a single z costs one counting pass per digit and no scatter.
+    void sortByHighBits(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+        constexpr int digitBits = 11;
+        constexpr uint64_t digitMask = (1u << digitBits) - 1;
+        if (keys.size() < 2)
+            return;
+
+        scratch.resize(keys.size());
+        for (int shift = 32; shift < 64; shift += digitBits) {
+            std::array<uint32_t, digitMask + 1> counts{};
+            for (const auto key : keys) {
+                ++counts[(key >> shift) & digitMask];
+            }
+            if (counts[(keys.front() >> shift) & digitMask] == keys.size())
+                continue;
+
+            uint32_t offset = 0;
+            for (auto& count : counts) {
+                const auto n = count;
+                count = offset;
+                offset += n;
+            }
+            for (const auto key : keys) {
+                scratch[counts[(key >> shift) & digitMask]++] = key;
+            }
+            keys.swap(scratch);
+        }
+    }
+}
 
 namespace rlge {
     RenderQueue::RenderQueue() {
@@ -40,6 +77,118 @@ namespace rlge {
         return it->second;
     }
 
+    void RenderQueue::buildVertices(SpriteBatch& batch) {
+        const size_t count = batch.quads.size();
+        batch.vertices.resize(count * 4);
+        batch.bounds.resize(count);
+        if (batch.texture.id == 0)
+            return; // never drawn, like DrawTexturePro
+
+        // Sorting 8-byte keys is much cheaper than moving the quads around. Flipping the sign bit (or all bits of
+        // a negative float) makes the z bits compare like the floats.
+        batch.order.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto bits = std::bit_cast<uint32_t>(batch.quads[i].z);
+            bits ^= (bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+            batch.order[i] = (static_cast<uint64_t>(bits) << 32) | i;
+        }
+        sortByHighBits(batch.order, sortScratch_);
+
+        // The corners and texture coordinates DrawTexturePro would compute, once per frame instead of once per
+        // view, and the rotation's sine and cosine only for quads that are rotated.
+        const float invWidth = 1.0f / static_cast<float>(batch.texture.width);
+        const float invHeight = 1.0f / static_cast<float>(batch.texture.height);
+        for (size_t i = 0; i < count; ++i) {
+            const auto& quad = batch.quads[static_cast<uint32_t>(batch.order[i])];
+            Rectangle src = quad.src;
+            const bool flipX = src.width < 0.0f;
+            if (flipX)
+                src.width = -src.width;
+            if (src.height < 0.0f)
+                src.y -= src.height;
+            const float width = std::abs(quad.dest.width);
+            const float height = std::abs(quad.dest.height);
+
+            Vector2 topLeft;
+            Vector2 topRight;
+            Vector2 bottomLeft;
+            Vector2 bottomRight;
+            if (quad.rotation == 0.0f) {
+                const float x = quad.dest.x - quad.origin.x;
+                const float y = quad.dest.y - quad.origin.y;
+                topLeft = {x, y};
+                topRight = {x + width, y};
+                bottomLeft = {x, y + height};
+                bottomRight = {x + width, y + height};
+            }
+            else {
+                const float s = std::sin(quad.rotation * DEG2RAD);
+                const float c = std::cos(quad.rotation * DEG2RAD);
+                const float dx = -quad.origin.x;
+                const float dy = -quad.origin.y;
+                // Rotated offsets of the left/right edges and the top/bottom edges, shared by the corners
+                const float leftX = dx * c;
+                const float leftY = dx * s;
+                const float rightX = (dx + width) * c;
+                const float rightY = (dx + width) * s;
+                const float topX = dy * s;
+                const float topY = dy * c;
+                const float bottomX = (dy + height) * s;
+                const float bottomY = (dy + height) * c;
+                topLeft = {quad.dest.x + leftX - topX, quad.dest.y + leftY + topY};
+                topRight = {quad.dest.x + rightX - topX, quad.dest.y + rightY + topY};
+                bottomLeft = {quad.dest.x + leftX - bottomX, quad.dest.y + leftY + bottomY};
+                bottomRight = {quad.dest.x + rightX - bottomX, quad.dest.y + rightY + bottomY};
+            }
+
+            const float u0 = src.x * invWidth;
+            const float u1 = (src.x + src.width) * invWidth;
+            const float v0 = src.y * invHeight;
+            const float v1 = (src.y + src.height) * invHeight;
+            const float left = flipX ? u1 : u0;
+            const float right = flipX ? u0 : u1;
+
+            // Same winding as DrawTexturePro: top-left, bottom-left, bottom-right, top-right
+            auto* v = &batch.vertices[i * 4];
+            v[0] = SpriteVertex{topLeft, {left, v0}, quad.tint};
+            v[1] = SpriteVertex{bottomLeft, {left, v1}, quad.tint};
+            v[2] = SpriteVertex{bottomRight, {right, v1}, quad.tint};
+            v[3] = SpriteVertex{topRight, {right, v0}, quad.tint};
+
+            const float minX = std::min(std::min(topLeft.x, topRight.x), std::min(bottomLeft.x, bottomRight.x));
+            const float minY = std::min(std::min(topLeft.y, topRight.y), std::min(bottomLeft.y, bottomRight.y));
+            const float maxX = std::max(std::max(topLeft.x, topRight.x), std::max(bottomLeft.x, bottomRight.x));
+            const float maxY = std::max(std::max(topLeft.y, topRight.y), std::max(bottomLeft.y, bottomRight.y));
+            batch.bounds[i] = Rectangle{minX, minY, maxX - minX, maxY - minY};
+        }
+    }
+
+    size_t RenderQueue::drawBatch(const SpriteBatch& batch, const Rectangle* view) {
+        if (batch.texture.id == 0)
+            return 0;
+
+        // One rlgl primitive for the whole batch; rlgl starts a new buffer on its own when one fills up.
+        size_t drawn = 0;
+        rlSetTexture(batch.texture.id);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (size_t i = 0; i < batch.bounds.size(); ++i) {
+            if (view && !CheckCollisionRecs(batch.bounds[i], *view))
+                continue;
+
+            const auto* v = &batch.vertices[i * 4];
+            rlColor4ub(v[0].tint.r, v[0].tint.g, v[0].tint.b, v[0].tint.a);
+            for (int k = 0; k < 4; ++k) {
+                rlTexCoord2f(v[k].uv.x, v[k].uv.y);
+                rlVertex2f(v[k].position.x, v[k].position.y);
+            }
+            ++drawn;
+        }
+        rlEnd();
+        rlSetTexture(0);
+        return drawn;
+    }
+
     void RenderQueue::submit(RenderLayer layer, float z, std::function<void()> fn) {
         commands_.push_back(DrawCommand{layer, z, std::move(fn)});
         stats_.customCommands++;
@@ -50,6 +199,34 @@ namespace rlge {
         submit(layer, 0.0f, std::move(fn));
     }
 
+    void RenderQueue::submitDebugLine(Vector2 a, Vector2 b, float thickness, Color color) {
+        debugLines_.push_back(DebugLine{a, b, thickness, color});
+        stats_.debugLines++;
+    }
+
+    void RenderQueue::submitDebugLines(std::span<const Vector2> points, bool closed, float thickness, Color color) {
+        const size_t n = points.size();
+        if (n < 2)
+            return;
+
+        const size_t segments = closed ? n : n - 1;
+        debugLines_.reserve(debugLines_.size() + segments);
+        for (size_t i = 0; i < segments; ++i) {
+            debugLines_.push_back(DebugLine{points[i], points[(i + 1) % n], thickness, color});
+        }
+        stats_.debugLines += segments;
+    }
+
+    void RenderQueue::submitDebugRect(const Rectangle& rect, float thickness, Color color) {
+        const Vector2 corners[4] = {
+            {rect.x, rect.y},
+            {rect.x + rect.width, rect.y},
+            {rect.x + rect.width, rect.y + rect.height},
+            {rect.x, rect.y + rect.height}
+        };
+        submitDebugLines(corners, true, thickness, color);
+    }
+
     void RenderQueue::beginFrame() {
         stats_.reset();
         worldPrepared_ = false;
@@ -62,6 +239,7 @@ namespace rlge {
             }
         }
         commands_.clear();
+        debugLines_.clear();
         worldPrepared_ = false;
     }
 
@@ -117,10 +295,7 @@ namespace rlge {
                 if (batch.quads.empty())
                     continue;
 
-                std::sort(batch.quads.begin(), batch.quads.end(),
-                          [](const SpriteQuad& a, const SpriteQuad& b) {
-                              return a.z < b.z;
-                          });
+                buildVertices(batch);
                 stats_.batchCount++;
             }
         }
@@ -129,7 +304,7 @@ namespace rlge {
             commands_.begin(),
             commands_.end(),
             [](const DrawCommand& cmd) { return cmd.layer != RenderLayer::UI; });
-        stats_.drawCalls = stats_.batchCount + worldCommands;
+        stats_.drawCalls = stats_.batchCount + worldCommands + (debugLines_.empty() ? 0 : 1);
 
         const auto endTime = std::chrono::high_resolution_clock::now();
         stats_.sortTimeMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
@@ -163,24 +338,7 @@ namespace rlge {
                 if (batch.quads.empty())
                     continue;
 
-                bool batchRendered = false;
-                for (const auto& quad : batch.quads) {
-                    const Rectangle quadBounds{
-                        quad.dest.x - quad.origin.x,
-                        quad.dest.y - quad.origin.y,
-                        std::abs(quad.dest.width),
-                        std::abs(quad.dest.height)
-                    };
-
-                    if (!CheckCollisionRecs(quadBounds, viewBounds))
-                        continue;
-
-                    DrawTexturePro(batch.texture, quad.src, quad.dest,
-                                   quad.origin, quad.rotation, quad.tint);
-                    batchRendered = true;
-                }
-
-                if (batchRendered)
+                if (drawBatch(batch, &viewBounds) > 0)
                     drawCallsThisView++;
             }
 
@@ -192,6 +350,26 @@ namespace rlge {
             }
         }
 
+        // Debug lines go on top of every world layer, all in the same pass.
+        bool debugRendered = false;
+        for (const auto& line : debugLines_) {
+            const Rectangle lineBounds{
+                std::min(line.a.x, line.b.x) - line.thickness,
+                std::min(line.a.y, line.b.y) - line.thickness,
+                std::abs(line.b.x - line.a.x) + 2.0f * line.thickness,
+                std::abs(line.b.y - line.a.y) + 2.0f * line.thickness
+            };
+
+            if (!CheckCollisionRecs(lineBounds, viewBounds))
+                continue;
+
+            DrawLineEx(line.a, line.b, line.thickness, line.color);
+            debugRendered = true;
+        }
+
+        if (debugRendered)
+            drawCallsThisView++;
+
         EndMode2D();
 
         stats_.viewsRendered++;
@@ -210,15 +388,8 @@ namespace rlge {
             if (batch.quads.empty())
                 continue;
 
-            std::ranges::sort(batch.quads,
-                      [](const SpriteQuad& a, const SpriteQuad& b) {
-                          return a.z < b.z;
-                      });
-
-            for (const auto& quad : batch.quads) {
-                DrawTexturePro(batch.texture, quad.src, quad.dest,
-                               quad.origin, quad.rotation, quad.tint);
-            }
+            buildVertices(batch);
+            drawBatch(batch, nullptr);
 
             stats_.drawCalls++;
             stats_.batchCount++;
@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 #include <unordered_map>
 
@@ -23,13 +25,30 @@ namespace rlge {
         float z;  // For sorting within batch
     };
 
+    // Corner of a sprite quad, already transformed
+    struct SpriteVertex {
+        Vector2 position;
+        Vector2 uv;
+        Color tint;
+    };
+
     // Batch of sprites sharing the same texture
     struct SpriteBatch {
         RenderLayer layer;
         Texture2D texture;
-        std::vector<SpriteQuad> quads;
-
-        void clear() { quads.clear(); }
+        std::vector<SpriteQuad> quads; // in submission order
+        // Rebuilt before drawing: the quads sorted by z (submission order among equal z) as z bits and quad
+        // index, and in that order four corners per quad and the bounds of each quad
+        std::vector<uint64_t> order;
+        std::vector<SpriteVertex> vertices;
+        std::vector<Rectangle> bounds;
+
+        void clear() {
+            quads.clear();
+            order.clear();
+            vertices.clear();
+            bounds.clear();
+        }
         void reserve(size_t n) { quads.reserve(n); }
     };
 
@@ -40,12 +59,21 @@ namespace rlge {
         std::function<void()> draw;
     };
 
+    // Segment of the debug line batch
+    struct DebugLine {
+        Vector2 a;
+        Vector2 b;
+        float thickness;
+        Color color;
+    };
+
     // Performance metrics
     struct RenderStats {
         size_t spritesSubmitted = 0;
         size_t batchCount = 0;
         size_t drawCalls = 0;
         size_t customCommands = 0;
+        size_t debugLines = 0;
         size_t viewsRendered = 0;
         size_t executedDrawCalls = 0;
         float sortTimeMs = 0.0f;
@@ -56,6 +84,7 @@ namespace rlge {
             batchCount = 0;
             drawCalls = 0;
             customCommands = 0;
+            debugLines = 0;
             viewsRendered = 0;
             executedDrawCalls = 0;
             sortTimeMs = 0.0f;
@@ -85,6 +114,14 @@ namespace rlge {
         void submitForeground(float z, std::function<void()> fn);
         void submitUI(std::function<void()> fn);
 
+        // Debug line batch, drawn on top of the world in a single pass per view. Segments outside a view's bounds
+        // are skipped for that view. Meant for many small overlays, like collider outlines, where a command per
+        // shape would cost an allocation and a draw call each.
+        void submitDebugLine(Vector2 a, Vector2 b, float thickness, Color color);
+        // Connects consecutive points, and the last one back to the first when closed.
+        void submitDebugLines(std::span<const Vector2> points, bool closed, float thickness, Color color);
+        void submitDebugRect(const Rectangle& rect, float thickness, Color color);
+
         void beginFrame();
         void clear();
         // Prepare world-space data (sorting batches/commands) once per frame.
@@ -105,11 +142,18 @@ namespace rlge {
         // Custom draw commands
         std::vector<DrawCommand> commands_;
 
+        std::vector<DebugLine> debugLines_;
+        std::vector<uint64_t> sortScratch_;
+
         // Stats
         RenderStats stats_;
         bool worldPrepared_ = false;
 
         // Helper methods
         SpriteBatch& getBatch(RenderLayer layer, Texture2D texture);
+        // Sorts the quads and builds their vertices
+        void buildVertices(SpriteBatch& batch);
+        // Streams the quads whose bounds overlap `view` (all of them when null) to rlgl; returns how many.
+        static size_t drawBatch(const SpriteBatch& batch, const Rectangle* view);
     };
 }
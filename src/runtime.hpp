@@ -29,6 +29,8 @@ namespace rlge {
 
     class GameServices {
     public:
+        GameServices() { collisions_.setEventBus(&events_); }
+
         CollisionSystem& collisions() { return collisions_; }
         EventBus& events() { return events_; }
         TweenSystem& tweens() { return tweens_; }
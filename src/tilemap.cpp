@@ -110,6 +110,7 @@ namespace rlge {
             auto& cell = tiles[tileY * mapW + tileX];
             cell.index = static_cast<int>(tile->getGid()) - tileset.getFirstgid();
             cell.flipFlags = static_cast<std::uint32_t>(tile->getFlipFlags());
+            cell.solid = tile->getProperties().hasProperty("solid") && tile->get<bool>("solid");
         }
 
         int margin = tileset.getMargin();
@@ -141,6 +142,13 @@ namespace rlge {
                                     columns);
     }
 
+    std::vector<std::uint8_t> Tilemap::solidity() const {
+        const bool flagged = std::ranges::any_of(data_, [](const TileCell& c) { return c.solid; });
+        if (flagged)
+            return solidity([](const TileCell& c) { return c.solid; });
+        return solidity([](const TileCell& c) { return c.index >= 0; });
+    }
+
     void Tilemap::draw() {
         const auto* tr = get<Transform>();
         const Vector2 offset = tr ? tr->position : Vector2{0, 0};
@@ -16,6 +16,7 @@ namespace rlge {
         struct TileCell {
             int index = -1;
             std::uint32_t flipFlags = 0;
+            bool solid = false; // boolean "solid" property of the tile in Tiled
         };
 
         Tilemap(Scene& scene,
@@ -44,6 +45,21 @@ namespace rlge {
         int tileWidth() const { return tw_; }
         int tileHeight() const { return th_; }
 
+        [[nodiscard]] const TileCell& cell(const int x, const int y) const { return data_[y * width_ + x]; }
+
+        // Solidity bitmap for a TileGridCollider: one byte per tile, row-major, non-zero where isSolid(cell) holds.
+        template <typename Pred>
+        [[nodiscard]] std::vector<std::uint8_t> solidity(Pred&& isSolid) const {
+            std::vector<std::uint8_t> solid(data_.size());
+            for (size_t i = 0; i < data_.size(); ++i) {
+                solid[i] = isSolid(data_[i]) ? 1 : 0;
+            }
+            return solid;
+        }
+
+        // Tiles with the "solid" property set, or every non-empty tile when no tile sets it.
+        [[nodiscard]] std::vector<std::uint8_t> solidity() const;
+
     private:
         Texture2D& texture_;
         int tw_;
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+
 #include "component.hpp"
 #include "raylib.h"
 #include "raymath.h"
@@ -7,12 +9,26 @@ namespace rlge {
     class Transform : public Component {
     public:
         explicit Transform(Entity& e)
-            : Component(e), position{0,0}, rotation(0.0f), scale{1.0f,1.0f} {}
+            : Component(e), position{0,0}, rotation(0.0f), scale{1.0f,1.0f}
+            , seenPosition_(position), seenRotation_(rotation), seenScale_(scale) {}
 
         Vector2 position;
         float   rotation;
         Vector2 scale;
 
+        // Change counter for caches derived from this transform (e.g. collider world geometry).
+        // Bumps whenever position, rotation or scale differ from the values seen on the previous call.
+        [[nodiscard]] std::uint32_t version() const {
+            if (position.x != seenPosition_.x || position.y != seenPosition_.y || rotation != seenRotation_ ||
+                scale.x != seenScale_.x || scale.y != seenScale_.y) {
+                seenPosition_ = position;
+                seenRotation_ = rotation;
+                seenScale_ = scale;
+                ++version_;
+            }
+            return version_;
+        }
+
         [[nodiscard]] Matrix matrix() const {
             const auto t = MatrixTranslate(position.x, position.y, 0.0f);
             const auto r = MatrixRotateZ(rotation);
@@ -29,5 +45,11 @@ namespace rlge {
         [[nodiscard]] Vector2 up() const {
             return Vector2Rotate({0.0f, 1.0f}, rotation);
         }
+
+    private:
+        mutable Vector2 seenPosition_;
+        mutable float seenRotation_;
+        mutable Vector2 seenScale_;
+        mutable std::uint32_t version_ = 1;
     };
 }